@@ -0,0 +1,168 @@
+/* autopilot.c -- Drive the Snake without a player
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "autopilot.h"
+
+Autopilot *newAutopilot(const int width, const int height) {
+  Autopilot *self = malloc(sizeof(Autopilot));
+  self->width = width;
+  self->height = height;
+  const int cells = width * height;
+  self->parent = malloc(sizeof(int[cells]));
+  self->queue = malloc(sizeof(int[cells]));
+  self->path = malloc(sizeof(Point[cells]));
+  self->pathLength = self->pathNext = 0;
+  self->target = (Point){-1, -1};
+  self->budget = 4096; // Cells expanded per replan before falling back
+  return self;
+}
+
+void destroyAutopilot(Autopilot *self) {
+  if (self != NULL) {
+    free(self->parent);
+    free(self->queue);
+    free(self->path);
+    free(self);
+  }
+}
+
+static int cellIndex(const Autopilot *self, const Point pos) {
+  return pos.y * self->width + pos.x;
+}
+
+static bool inside(const Autopilot *self, const Point pos) {
+  return pos.x >= 0 && pos.x < self->width && pos.y >= 0 &&
+         pos.y < self->height;
+}
+
+static Direction directionTo(const Point from, const Point to) {
+  if (to.y < from.y)
+    return NORTH;
+  if (to.x > from.x)
+    return EAST;
+  if (to.y > from.y)
+    return SOUTH;
+  return WEST;
+}
+
+// Breadth-first search from head toward target over the free cells. True
+// when a path was found within the budget; it is left in self->path, head
+// excluded, target included. throughTarget admits an occupied target,
+// for steering at a cell that is about to vacate.
+static bool replan(Autopilot *self, const Grid *grid, const Point head,
+                   const Point target, const bool throughTarget) {
+  const int cells = self->width * self->height;
+  memset(self->parent, -1, sizeof(int[cells])); // All bits set is -1
+  const int start = cellIndex(self, head), goal = cellIndex(self, target);
+  self->parent[start] = start;
+  self->queue[0] = start;
+  int expanded = 0;
+  for (int tail = 0, count = 1; tail < count; ++tail) {
+    if (++expanded > self->budget)
+      return false; // Out of budget, try again next tick
+    const int current = self->queue[tail];
+    if (current == goal) {
+      // Walk the parents back to the head, then flip the cells in place
+      self->pathLength = 0;
+      for (int cell = goal; cell != start; cell = self->parent[cell])
+        self->path[self->pathLength++] =
+            (Point){cell % self->width, cell / self->width};
+      for (int low = 0, high = self->pathLength - 1; low < high;
+           ++low, --high) {
+        const Point swap = self->path[low];
+        self->path[low] = self->path[high];
+        self->path[high] = swap;
+      }
+      self->pathNext = 0;
+      self->target = target;
+      return true;
+    }
+    const Point from = {current % self->width, current / self->width};
+    for (int d = NORTH; d <= WEST; ++d) {
+      const Point next = movedPoint(from, d, 1);
+      if (!inside(self, next))
+        continue;
+      const int index = cellIndex(self, next);
+      if (gridOccupied(grid, next) && !(throughTarget && index == goal))
+        continue;
+      if (self->parent[index] == -1) {
+        self->parent[index] = current;
+        self->queue[count++] = index;
+      }
+    }
+  }
+  return false; // The body walls the orb off entirely
+}
+
+// The free neighbor closest to the orb, or straight on when boxed in
+static Direction greedyStep(const Autopilot *self, const Grid *grid,
+                            const Snake *snake, const Point orb) {
+  const Point head = snake->cell[snake->head];
+  Direction best = snake->direction;
+  int bestDistance = INT_MAX;
+  for (int d = NORTH; d <= WEST; ++d) {
+    if (snake->length > 1 && d == (snake->direction + 2) % (WEST + 1))
+      continue; // Cannot reverse into the neck
+    const Point next = movedPoint(head, d, 1);
+    if (!inside(self, next) || gridOccupied(grid, next))
+      continue;
+    const int distance = abs(next.x - orb.x) + abs(next.y - orb.y);
+    if (distance < bestDistance) {
+      bestDistance = distance;
+      best = d;
+    }
+  }
+  return best;
+}
+
+Direction autopilotSteer(Autopilot *self, const Grid *grid,
+                         const Snake *snake, const Point orb) {
+  const Point head = snake->cell[snake->head];
+
+  // The common tick changes one head and one tail cell, which never
+  // invalidates a path that avoids the body, so just consume the next step
+  if (self->pathNext < self->pathLength && self->target.x == orb.x &&
+      self->target.y == orb.y) {
+    const Point next = self->path[self->pathNext];
+    // The target itself is fine to enter even though the Grid marks it
+    if (abs(next.x - head.x) + abs(next.y - head.y) == 1 &&
+        (!gridOccupied(grid, next) ||
+         (next.x == orb.x && next.y == orb.y))) {
+      ++self->pathNext;
+      return directionTo(head, next);
+    }
+  }
+
+  // Orb cells are marked in the Grid, hence throughTarget
+  if (replan(self, grid, head, orb, true)) {
+    ++self->pathNext;
+    return directionTo(head, self->path[0]);
+  }
+  self->pathLength = self->pathNext = 0; // Nothing cached worth keeping
+
+  // No way to the orb right now. Chase the tail instead: the cell it is
+  // on keeps vacating, so following it holds out until the body unwinds
+  // and a replan toward the orb succeeds.
+  if (snake->length > 1 && !snake->growing &&
+      replan(self, grid, head, *snakeTail((Snake *)snake), true)) {
+    const Direction step = directionTo(head, self->path[0]);
+    self->pathLength = self->pathNext = 0; // Re-examined every tick
+    return step;
+  }
+  return greedyStep(self, grid, snake, orb);
+}
@@ -0,0 +1,46 @@
+/* autopilot.h -- Drive the Snake without a player
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include "grid.h"
+#include "snake.h"
+
+/* The autopilot plans a path over the occupancy Grid toward the orb and
+ * feeds one Direction per tick into the same changeDirection() path the
+ * keyboard uses. A plan is a breadth-first search, but it only runs when
+ * the cached path stops matching the board: between orbs the delta per
+ * tick is one head and one tail cell, so the previous path is simply
+ * consumed step by step. The search expands at most `budget` cells per
+ * call; when it runs out it falls back to a greedy free-neighbor step and
+ * tries again next tick, so a huge map never blows the tick deadline. */
+typedef struct autopilot {
+  int width, height; // Same geometry as the Grid it steers over
+  int *parent;       // BFS parent of every cell, -1 when not reached
+  int *queue;        // BFS frontier, holds each cell at most once
+  Point *path;       // Cells to visit, path[pathNext] is the next one
+  int pathLength, pathNext;
+  Point target; // The orb the cached path leads to
+  int budget;   // Cells the search may expand per call
+} Autopilot;
+
+Autopilot *newAutopilot(const int width, const int height);
+void destroyAutopilot(Autopilot *self);
+
+// The Direction to take this tick, toward orb and around the body
+Direction autopilotSteer(Autopilot *self, const Grid *grid,
+                         const Snake *snake, const Point orb);
+
+#endif // !AUTOPILOT_H
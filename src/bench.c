@@ -0,0 +1,154 @@
+/* bench.c -- Benchmark harness for the simulation core
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <ncurses.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "grid.h"
+#include "rng.h"
+#include "screen.h"
+#include "snake.h"
+
+/* Runs the core loop for a scripted workload at several body lengths and
+ * times each phase: advance, grid collision bookkeeping, orb placement and
+ * rendering into a null terminal. One machine-readable line per length:
+ *   bench length=L ticks=N advance_ns=A collision_ns=C orb_ns=O render_ns=R
+ * where the figures are nanoseconds per tick. Usage: snake-bench [ticks] */
+
+#define BENCH_WIDTH 512
+
+static long long monotonicNanos(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+// Sweep the map row by row, EAST across one row and WEST across the next,
+// so the path never revisits a cell until the body has long left it
+static Direction steer(Snake *snake) {
+  const Point head = *snakeHead(snake);
+  if (snake->direction == EAST && head.x == BENCH_WIDTH - 1)
+    return SOUTH;
+  if (snake->direction == WEST && head.x == 0)
+    return SOUTH;
+  if (snake->direction == SOUTH)
+    return head.x == 0 ? EAST : WEST;
+  return snake->direction;
+}
+
+// One tick of the render pipeline on a dedicated length-1 snake shuttling
+// between two cells, since the cells drawn per frame do not depend on the
+// body length
+static void renderTick(Screen *screen, Snake *snake) {
+  changeDirection(snake, snake->direction == EAST ? WEST : EAST);
+  advance(snake);
+  draw(screen, snake);
+  presentFrame(screen);
+}
+
+static void benchLength(const unsigned length, const unsigned ticks,
+                        Screen *screen, Snake *renderSnake) {
+  const int height = (ticks + length) / BENCH_WIDTH + 4;
+  Grid *grid = newGrid(BENCH_WIDTH, height);
+  Rng rng;
+  rngSeed(&rng, 1);
+
+  Snake *snake = newSnake((Point){0, 0});
+  snake->direction = EAST;
+  gridMark(grid, *snakeHead(snake));
+
+  // Grow the body to the wanted length, untimed
+  while (snake->length < length) {
+    changeDirection(snake, steer(snake));
+    snake->growing = true;
+    ++snake->length;
+    advance(snake);
+    gridMark(grid, *snakeHead(snake));
+  }
+
+  long long advanceNs = 0, collisionNs = 0, orbNs = 0, renderNs = 0;
+  for (unsigned i = 0; i < ticks; ++i) {
+    const long long start = monotonicNanos();
+    changeDirection(snake, steer(snake));
+    advance(snake);
+    const long long advanced = monotonicNanos();
+    advanceNs += advanced - start;
+
+    gridClear(grid, snake->oldTail);
+    if (gridOccupied(grid, *snakeHead(snake)))
+      abort(); // The sweep never self-collides
+    gridMark(grid, *snakeHead(snake));
+    const long long collided = monotonicNanos();
+    collisionNs += collided - advanced;
+
+    gridRandomFree(grid, &rng);
+    const long long placed = monotonicNanos();
+    orbNs += placed - collided;
+
+    if (screen != NULL) {
+      renderTick(screen, renderSnake);
+      renderNs += monotonicNanos() - placed;
+    }
+  }
+
+  printf("bench length=%u ticks=%u advance_ns=%lld collision_ns=%lld "
+         "orb_ns=%lld render_ns=%lld\n",
+         length, ticks, advanceNs / ticks, collisionNs / ticks, orbNs / ticks,
+         screen != NULL ? renderNs / ticks : -1);
+
+  destroySnake(snake);
+  destroyGrid(grid);
+}
+
+int main(int argc, char **argv) {
+  const unsigned ticks = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+  static const unsigned lengths[] = {10, 1000, 100000};
+
+  // Render into a throwaway terminal writing to /dev/null, so the render
+  // phase is measured without flooding the real one. When no terminal
+  // description is available the phase is skipped and reported as -1.
+  FILE *null = fopen("/dev/null", "r+");
+  SCREEN *term = newterm(getenv("TERM") != NULL ? NULL : "ansi", null, null);
+  Screen *screen = NULL;
+  Snake *renderSnake = NULL;
+  Rng rng;
+  rngSeed(&rng, 1);
+  if (term != NULL) {
+    start_color();
+    use_default_colors();
+    screen = newScreen();
+    Grid *renderGrid = newGrid(screen->mapWidth + 1, screen->mapHeight + 1);
+    screen->grid = renderGrid;
+    screen->rng = &rng;
+    renderSnake = newSnake((Point){0, 0});
+    renderSnake->direction = WEST; // First toggle sends it EAST, on the map
+    drawWalls(screen);
+  }
+
+  for (unsigned i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i)
+    benchLength(lengths[i], ticks, screen, renderSnake);
+
+  if (term != NULL) {
+    destroyGrid(screen->grid);
+    destroyScreen(screen);
+    destroySnake(renderSnake);
+    endwin();
+    delscreen(term);
+  }
+  if (null != NULL)
+    fclose(null);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+/* engine.c -- Implementation of the class Engine
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "engine.h"
+
+Engine *newMultiEngine(const int width, const int height,
+                       const unsigned snakeCount, const unsigned seed) {
+  Engine *self = malloc(sizeof(Engine));
+  self->width = width;
+  self->height = height;
+  self->snakeCount = snakeCount;
+  self->aliveCount = snakeCount;
+  rngSeed(&self->rng, seed);
+  self->grid = newGrid(width, height);
+
+  self->snake = malloc(sizeof(Snake * [snakeCount]));
+  self->alive = malloc(sizeof(bool[snakeCount]));
+  self->collision = malloc(sizeof(Point[snakeCount]));
+  for (unsigned s = 0; s < snakeCount; ++s) {
+    // Spread the contenders evenly along the middle row
+    self->snake[s] =
+        newSnake((Point){width * (s + 1) / (snakeCount + 1), height / 2});
+    self->snake[s]->direction = EAST;
+    self->alive[s] = true;
+    self->collision[s] = (Point){-1, -1};
+    gridMark(self->grid, *snakeHead(self->snake[s]));
+  }
+
+  self->orb = gridRandomFree(self->grid, &self->rng);
+  self->tick = 0;
+  self->ate = false;
+  self->over = false;
+  self->won = false;
+  return self;
+}
+
+Engine *newEngine(const int width, const int height, const unsigned seed) {
+  return newMultiEngine(width, height, 1, seed);
+}
+
+void destroyEngine(Engine *self) {
+  if (self != NULL) {
+    for (unsigned s = 0; s < self->snakeCount; ++s)
+      destroySnake(self->snake[s]);
+    free(self->snake);
+    free(self->alive);
+    free(self->collision);
+    destroyGrid(self->grid);
+    free(self);
+    self = NULL;
+  }
+}
+
+// Take a dead Snake off the board. Its head cell is skipped: either it is
+// off the map or it belongs to the body it crashed into.
+static void unmark(Engine *self, Snake *snake) {
+  for (unsigned i = 1; i < snake->length; ++i)
+    gridClear(self->grid, *snakeSegment(snake, i));
+}
+
+bool engineTick(Engine *self) {
+  if (self->over)
+    return false;
+
+  self->ate = false;
+  ++self->tick;
+
+  for (unsigned s = 0; s < self->snakeCount; ++s) {
+    if (!self->alive[s])
+      continue;
+    Snake *snake = self->snake[s];
+    advance(snake);
+    const Point head = *snakeHead(snake);
+
+    // Same discipline as the interactive loop: free the vacated tail cell,
+    // then a single lookup tells whether the head ran into any body
+    if (!snake->growing)
+      gridClear(self->grid, snake->oldTail);
+
+    if (head.x < 0 || head.x >= self->width || head.y < 0 ||
+        head.y >= self->height) { // Ran into a wall
+      self->alive[s] = false;
+      --self->aliveCount;
+      unmark(self, snake);
+      continue;
+    }
+    if (gridOccupied(self->grid, head)) {
+      self->collision[s] = head;
+      self->alive[s] = false;
+      --self->aliveCount;
+      unmark(self, snake);
+      continue;
+    }
+    gridMark(self->grid, head);
+
+    if (head.x == self->orb.x && head.y == self->orb.y) {
+      snake->growing = true;
+      ++snake->length;
+      self->ate = true;
+      if (self->grid->freeCount == 0) { // This Snake covers the whole map
+        self->won = true;
+        self->over = true;
+        return false;
+      }
+      self->orb = gridRandomFree(self->grid, &self->rng);
+    }
+  }
+
+  if (self->aliveCount == 0)
+    self->over = true;
+  return !self->over;
+}
@@ -0,0 +1,61 @@
+/* engine.h -- Interface of the class Engine
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <stdbool.h>
+
+#include "grid.h"
+#include "rng.h"
+#include "snake.h"
+
+// The game without the terminal: any number of Snakes on one map, the
+// shared occupancy Grid and the orb, advanced one tick at a time. Because
+// every body cell of every Snake is marked in the one Grid, head-versus-
+// any-body collision stays a single lookup per snake per tick. It has no
+// ncurses dependency, so thousands of games can be simulated in a batch.
+typedef struct engine {
+  int width, height;    // Dimensions of the map
+  unsigned snakeCount;  // How many Snakes started the match
+  unsigned aliveCount;  // How many are still going
+  Snake **snake;        // The contenders; the classic game is snakeCount 1
+  bool *alive;          // Whether each Snake is still in the game
+  Point *collision;     // Fatal cell of each Snake, (-1, -1) while alive
+  Grid *grid;           // Shared occupancy of every body
+  Rng rng;              // Every random draw of the game comes from here
+  Point orb;
+  unsigned tick; // Ticks simulated so far
+  bool ate;      // The orb was eaten during the last tick
+  bool over;     // The game ended
+  bool won;      // A Snake covered the whole map
+} Engine;
+
+// Two Engines created with the same dimensions and seed, fed the same
+// direction changes on the same ticks, play out identically
+Engine *newEngine(const int width, const int height, const unsigned seed);
+
+// Like newEngine() but with snakeCount Snakes spread across the map
+Engine *newMultiEngine(const int width, const int height,
+                       const unsigned snakeCount, const unsigned seed);
+
+void destroyEngine(Engine *self);
+
+// Simulate one tick: move every living Snake in its current direction,
+// handle the orb and detect collisions; a Snake that dies is unmarked from
+// the Grid so its cells become playable again. Steer beforehand with
+// changeDirection() on the snakes. Returns false once the game is over.
+bool engineTick(Engine *self);
+
+#endif // !ENGINE_H
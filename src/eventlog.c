@@ -0,0 +1,56 @@
+/* eventlog.c -- Append-only binary log of gameplay events
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "eventlog.h"
+
+EventLog *newEventLog(const char *path) {
+  FILE *file = fopen(path, "ab");
+  if (file == NULL)
+    return NULL;
+  EventLog *self = malloc(sizeof(EventLog));
+  self->file = file;
+  self->count = 0;
+  return self;
+}
+
+// One big write instead of one per record
+static void flush(EventLog *self) {
+  if (self->count > 0)
+    fwrite(self->buffered, sizeof(Event), self->count, self->file);
+  self->count = 0;
+}
+
+void destroyEventLog(EventLog *self) {
+  if (self != NULL) {
+    flush(self);
+    fclose(self->file);
+    free(self);
+    self = NULL;
+  }
+}
+
+void eventLogRecord(EventLog *self, const EventKind kind,
+                    const Direction direction, const Point pos,
+                    const unsigned score) {
+  self->buffered[self->count++] = (Event){.kind = kind,
+                                          .direction = direction,
+                                          .x = pos.x,
+                                          .y = pos.y,
+                                          .score = score};
+  if (self->count == EVENTLOG_BUFFER)
+    flush(self);
+}
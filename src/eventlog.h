@@ -0,0 +1,61 @@
+/* eventlog.h -- Append-only binary log of gameplay events
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <stdio.h>
+
+#include "snake.h"
+
+// What one record describes
+typedef enum {
+  EVENT_START, // A game began, pos is the initial head
+  EVENT_TICK,  // The Snake advanced one cell
+  EVENT_ORB,   // An orb was eaten at pos
+  EVENT_OVER,  // The game ended, pos is the collision
+} EventKind;
+
+// One gameplay event, eight bytes on disk. A whole evening of kiosk play
+// at 30 ticks per second is under ten megabytes.
+typedef struct event {
+  unsigned char kind;      // EventKind
+  unsigned char direction; // Direction travelled this tick
+  short x, y;              // The head, or see kind
+  unsigned short score;    // Snake length after the event
+} Event;
+
+// Records buffered between flushes: 32 KiB, one write each
+#define EVENTLOG_BUFFER 4096
+
+typedef struct eventLog {
+  Event buffered[EVENTLOG_BUFFER];
+  int count; // Records sitting in buffered
+  FILE *file;
+} EventLog;
+
+// Append to the log at path, creating it if needed. NULL when the file
+// cannot be opened.
+EventLog *newEventLog(const char *path);
+
+// Flushes whatever is still buffered
+void destroyEventLog(EventLog *self);
+
+// Store one record. The cost on the tick is one in-memory store; the
+// buffer reaches the file in large batched writes.
+void eventLogRecord(EventLog *self, const EventKind kind,
+                    const Direction direction, const Point pos,
+                    const unsigned score);
+
+#endif // !EVENTLOG_H
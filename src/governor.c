@@ -0,0 +1,63 @@
+/* governor.c -- Adaptive shedding of renderer work under overrun
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <stdlib.h>
+
+#include "governor.h"
+
+// Escalate after this many consecutive overruns: one lost frame is
+// noise, a run of them is a machine that cannot hold the rate
+#define OVERRUN_STREAK 8
+
+// De-escalate only after this many consecutive ticks at half budget or
+// less. The wide margin and the long streak are the hysteresis: a level
+// that was needed recently is cheap to keep and expensive to flap.
+#define UNDERRUN_STREAK 128
+
+Governor *newGovernor(void) {
+  Governor *self = malloc(sizeof(Governor));
+  self->level = 0;
+  self->overruns = 0;
+  self->underruns = 0;
+  return self;
+}
+
+void destroyGovernor(Governor *self) {
+  if (self != NULL) {
+    free(self);
+    self = NULL;
+  }
+}
+
+int governorUpdate(Governor *self, const long long workNs,
+                   const long long budgetNs) {
+  if (workNs > budgetNs) {
+    self->underruns = 0;
+    if (++self->overruns >= OVERRUN_STREAK &&
+        self->level < GOVERNOR_LEVEL_MAX) {
+      ++self->level;
+      self->overruns = 0;
+    }
+  } else if (workNs * 2 <= budgetNs) {
+    self->overruns = 0;
+    if (++self->underruns >= UNDERRUN_STREAK && self->level > 0) {
+      --self->level;
+      self->underruns = 0;
+    }
+  } else { // The borderline band advances neither streak
+    self->overruns = 0;
+    self->underruns = 0;
+  }
+  return self->level;
+}
@@ -0,0 +1,43 @@
+/* governor.h -- Adaptive shedding of renderer work under overrun
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+// Watches the measured work of every tick against its budget. When the
+// work itself cannot fit the budget for a sustained stretch the governor
+// raises its shed level, asking the caller to drop renderer niceties
+// before the simulation rate is ever allowed to stretch:
+//   0  full rendering
+//   1  refresh every other tick, batching two ticks per emission
+//   2  additionally skip the neck recolor
+// Both transitions require a streak, so the level does not oscillate
+// around the threshold on a machine that is merely borderline.
+typedef struct governor {
+  int level;     // Current shed level, 0 to GOVERNOR_LEVEL_MAX
+  int overruns;  // Consecutive ticks whose work exceeded the budget
+  int underruns; // Consecutive ticks comfortably inside the budget
+} Governor;
+
+#define GOVERNOR_LEVEL_MAX 2
+
+Governor *newGovernor(void);
+void destroyGovernor(Governor *self);
+
+// Feed one tick's measured work (simulate + render, not the input wait)
+// and its budget; returns the shed level the next tick should render at
+int governorUpdate(Governor *self, const long long workNs,
+                   const long long budgetNs);
+
+#endif // !GOVERNOR_H
@@ -0,0 +1,114 @@
+/* grid.c -- Implementation of the class Grid
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "grid.h"
+
+static int cellIndex(const Grid *self, const Point pos) {
+  return pos.y * self->width + pos.x;
+}
+
+static bool inside(const Grid *self, const Point pos) {
+  return pos.x >= 0 && pos.x < self->width && pos.y >= 0 &&
+         pos.y < self->height;
+}
+
+// The occupancy flags are packed 64 to a word: a cell is one bit, so even a
+// 500x200 tournament map fits the whole index in a few cache lines
+static int wordCount(const int cells) { return (cells + 63) / 64; }
+
+static bool testBit(const Grid *self, const int index) {
+  return (self->cell[index >> 6] >> (index & 63)) & 1;
+}
+
+Grid *newGrid(const int width, const int height) {
+  Grid *self = malloc(sizeof(Grid));
+  self->width = width;
+  self->height = height;
+  self->cell = malloc(sizeof(unsigned long long[wordCount(width * height)]));
+  self->freeCell = malloc(sizeof(Point[width * height]));
+  self->slot = malloc(sizeof(int[width * height]));
+  gridReset(self);
+  return self;
+}
+
+void destroyGrid(Grid *self) {
+  if (self != NULL) {
+    free(self->cell);
+    free(self->freeCell);
+    free(self->slot);
+    free(self);
+    self = NULL;
+  }
+}
+
+bool gridOccupied(const Grid *self, const Point pos) {
+  return !inside(self, pos) || testBit(self, cellIndex(self, pos));
+}
+
+void gridMark(Grid *self, const Point pos) {
+  if (!inside(self, pos))
+    return;
+  const int index = cellIndex(self, pos);
+  if (testBit(self, index))
+    return;
+  self->cell[index >> 6] |= 1ULL << (index & 63);
+
+  // Swap-remove the cell from the free index
+  const Point last = self->freeCell[--self->freeCount];
+  self->freeCell[self->slot[index]] = last;
+  self->slot[cellIndex(self, last)] = self->slot[index];
+  self->slot[index] = -1;
+}
+
+void gridClear(Grid *self, const Point pos) {
+  if (!inside(self, pos))
+    return;
+  const int index = cellIndex(self, pos);
+  if (!testBit(self, index))
+    return;
+  self->cell[index >> 6] &= ~(1ULL << (index & 63));
+
+  // Append the cell to the free index
+  self->freeCell[self->freeCount] = pos;
+  self->slot[index] = self->freeCount++;
+}
+
+void gridResize(Grid *self, const int width, const int height) {
+  self->width = width;
+  self->height = height;
+  self->cell = realloc(self->cell,
+                       sizeof(unsigned long long[wordCount(width * height)]));
+  self->freeCell = realloc(self->freeCell, sizeof(Point[width * height]));
+  self->slot = realloc(self->slot, sizeof(int[width * height]));
+  gridReset(self);
+}
+
+void gridReset(Grid *self) {
+  memset(self->cell, 0,
+         sizeof(unsigned long long[wordCount(self->width * self->height)]));
+  self->freeCount = 0;
+  for (int y = 0; y < self->height; ++y)
+    for (int x = 0; x < self->width; ++x) {
+      self->freeCell[self->freeCount] = (Point){x, y};
+      self->slot[self->freeCount] = self->freeCount;
+      ++self->freeCount;
+    }
+}
+
+Point gridRandomFree(const Grid *self, Rng *rng) {
+  return self->freeCell[rngBelow(rng, self->freeCount)];
+}
@@ -0,0 +1,58 @@
+/* grid.h -- Interface of the class Grid
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#ifndef GRID_H
+#define GRID_H
+
+#include <stdbool.h>
+
+#include "rng.h"
+#include "snake.h"
+
+// Occupancy index of the map. It belongs to the game state, not the
+// renderer: the game marks and clears cells as the Snake moves, so asking
+// "is this cell part of the body?" is a single lookup no matter how long
+// the Snake is.
+typedef struct grid {
+  int width, height;        // Dimensions of the map
+  unsigned long long *cell; // Occupancy bitset, row-major, 64 cells per word
+  Point *freeCell;          // Dense array of every currently free cell
+  int *slot;     // Index of each cell into freeCell, -1 when occupied
+  int freeCount; // How many entries of freeCell are in use
+} Grid;
+
+Grid *newGrid(const int width, const int height);
+void destroyGrid(Grid *self);
+
+// Adopt a new geometry after a terminal resize: the flat arrays are
+// regrown with one realloc each and every cell comes back free, so the
+// caller re-marks what is on the map.
+void gridResize(Grid *self, const int width, const int height);
+
+// Out-of-map positions count as occupied: the walls
+bool gridOccupied(const Grid *self, const Point pos);
+
+// Both are no-ops outside the map, so a body segment cut off by a
+// shrinking terminal needs no special casing
+void gridMark(Grid *self, const Point pos);
+void gridClear(Grid *self, const Point pos);
+
+// Clear every cell, for a new game on the same map
+void gridReset(Grid *self);
+
+// A uniformly random free cell, in constant time at any fill level.
+// The Grid must have at least one free cell.
+Point gridRandomFree(const Grid *self, Rng *rng);
+
+#endif // !GRID_H
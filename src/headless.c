@@ -0,0 +1,135 @@
+/* headless.c -- Batch simulation driver
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine.h"
+#include "replay.h"
+
+/* Drives the Engine from a stdin protocol, one character per tick:
+ *   w a s d  turn NORTH / WEST / SOUTH / EAST
+ *   .        keep going straight
+ *   q        give up
+ * Whitespace is ignored. On EOF the Snake keeps going straight until the
+ * game ends. The result is reported on stdout as
+ *   <win|over|quit> score <length> ticks <ticks>
+ *
+ * Usage: snake-headless [width height] [--seed N]
+ *                       [--record FILE | --replay FILE]
+ * The seed makes every random draw reproducible; --record writes an input
+ * trace and --replay re-executes one tick for tick, ignoring stdin. */
+int main(int argc, char **argv) {
+  int width = 80, height = 24, positionals = 0;
+  unsigned seed = 1;
+  const char *recordPath = NULL, *replayPath = NULL;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+      seed = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+      recordPath = argv[++i];
+    else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+      replayPath = argv[++i];
+    else if (positionals == 0)
+      width = atoi(argv[i]), ++positionals;
+    else if (positionals == 1)
+      height = atoi(argv[i]), ++positionals;
+    else {
+      fprintf(stderr,
+              "usage: %s [width height] [--seed N] "
+              "[--record FILE | --replay FILE]\n",
+              argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (width < 2 || height < 2) {
+    fprintf(stderr, "%s: the map must be at least 2x2\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  Replay *trace = NULL;
+  if (replayPath != NULL) {
+    trace = loadReplay(replayPath);
+    if (trace == NULL) {
+      fprintf(stderr, "%s: cannot load replay %s\n", argv[0], replayPath);
+      return EXIT_FAILURE;
+    }
+    width = trace->width; // The trace fixes the whole workload
+    height = trace->height;
+    seed = trace->seed;
+  }
+  Replay *recording = recordPath != NULL ? newReplay(width, height, seed) : NULL;
+
+  Engine *engine = newEngine(width, height, seed);
+  bool gaveUp = false;
+
+  if (trace != NULL) {
+    // Playback: re-execute the recorded game tick for tick
+    int direction;
+    do {
+      while ((direction = replayNext(trace, engine->tick)) != -1)
+        changeDirection(engine->snake[0], direction);
+    } while (engineTick(engine));
+  } else {
+    int move;
+    while ((move = getchar()) != EOF && !gaveUp) {
+      Direction turn;
+      switch (move) {
+      case 'w':
+        turn = NORTH;
+        break;
+      case 'd':
+        turn = EAST;
+        break;
+      case 's':
+        turn = SOUTH;
+        break;
+      case 'a':
+        turn = WEST;
+        break;
+      case '.':
+        if (!engineTick(engine))
+          goto done;
+        continue;
+      case 'q':
+        gaveUp = true;
+        continue;
+      default: // Whitespace and anything else does not consume a tick
+        continue;
+      }
+      if (recording != NULL)
+        replayRecord(recording, engine->tick, turn);
+      changeDirection(engine->snake[0], turn);
+      if (!engineTick(engine))
+        break;
+    }
+    while (!gaveUp && !engine->over) // Coast straight after EOF
+      engineTick(engine);
+  }
+
+done:
+  if (recording != NULL && !replaySave(recording, recordPath))
+    fprintf(stderr, "%s: cannot write trace %s\n", argv[0], recordPath);
+
+  printf("%s score %u ticks %u\n",
+         gaveUp ? "quit" : (engine->won ? "win" : "over"),
+         engine->snake[0]->length, engine->tick);
+
+  destroyEngine(engine);
+  destroyReplay(recording);
+  destroyReplay(trace);
+  return EXIT_SUCCESS;
+}
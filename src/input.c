@@ -0,0 +1,57 @@
+/* input.c -- Implementation of the class InputQueue
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <stdlib.h>
+
+#include "input.h"
+
+InputQueue *newInputQueue(void) {
+  InputQueue *self = malloc(sizeof(InputQueue));
+  atomic_init(&self->head, 0);
+  atomic_init(&self->tail, 0);
+  return self;
+}
+
+void destroyInputQueue(InputQueue *self) { free(self); }
+
+bool inputPush(InputQueue *self, const int key) {
+  const unsigned head =
+      atomic_load_explicit(&self->head, memory_order_relaxed);
+  const unsigned tail =
+      atomic_load_explicit(&self->tail, memory_order_acquire);
+  if (head - tail == INPUT_QUEUE)
+    return false;
+  if (head != tail && self->key[(head - 1) & (INPUT_QUEUE - 1)] == key)
+    return true; // Collapsed into the previous identical key
+  self->key[head & (INPUT_QUEUE - 1)] = key;
+  atomic_store_explicit(&self->head, head + 1, memory_order_release);
+  return true;
+}
+
+int inputPop(InputQueue *self) {
+  const unsigned tail =
+      atomic_load_explicit(&self->tail, memory_order_relaxed);
+  const unsigned head =
+      atomic_load_explicit(&self->head, memory_order_acquire);
+  if (tail == head)
+    return -1;
+  const int key = self->key[tail & (INPUT_QUEUE - 1)];
+  atomic_store_explicit(&self->tail, tail + 1, memory_order_release);
+  return key;
+}
+
+void inputClear(InputQueue *self) {
+  while (inputPop(self) != -1)
+    ;
+}
@@ -0,0 +1,51 @@
+/* input.h -- Interface of the class InputQueue
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// Queued keystrokes, at most this many pending; a power of two
+#define INPUT_QUEUE 64
+
+// Pending direction keys between capture and simulation. The tick loop
+// drains every key the terminal has buffered and pushes the turns here,
+// then consumes exactly one per tick in arrival order, so a fast
+// double-tap within one tick is never lost. The ring is a lock-free
+// single-producer single-consumer queue — head and tail are each written
+// by one side only, published with release/acquire — so capture could
+// move to another thread without growing a lock.
+typedef struct inputQueue {
+  int key[INPUT_QUEUE];
+  _Atomic unsigned head; // Written by the producer only
+  _Atomic unsigned tail; // Written by the consumer only
+} InputQueue;
+
+InputQueue *newInputQueue(void);
+void destroyInputQueue(InputQueue *self);
+
+// Queue a key. Identical consecutive keys collapse, a held key would
+// otherwise only buy lag. False when the queue is full and the key was
+// dropped.
+bool inputPush(InputQueue *self, const int key);
+
+// The oldest queued key, or -1 (curses ERR) when none is pending
+int inputPop(InputQueue *self);
+
+// Throw away everything pending, for a fresh game
+void inputClear(InputQueue *self);
+
+#endif // !INPUT_H
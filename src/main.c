@@ -12,48 +12,247 @@
  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
  * GNU General Public License for more details. */
 
+#include <time.h>
 #include <unistd.h>
 #include <ncurses.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
 
+#include "autopilot.h"
+#include "eventlog.h"
+#include "governor.h"
+#include "grid.h"
+#include "input.h"
+#include "metrics.h"
+#include "pacing.h"
+#include "rng.h"
 #include "screen.h"
 #include "snake.h"
+#include "snapshot.h"
 
-static void resetGame(Screen *screen, Snake *snake, Point *collision,
-                      float *progress) {
-  destroyScreen(screen);
-  screen = newScreen();
-  destroySnake(snake);
-  snake = newSnake((Point){screen->mapWidth / 2, screen->mapHeight / 2});
+// Hour-long kiosk runs survive a power cycle through this file
+static const char *snapshotPath = "snake.save";
+
+// An optional custom difficulty curve lives here, see pacing.h
+static const char *pacingPath = "pacing.conf";
+
+// Gameplay events are appended here when --log is given
+static const char *eventsPath = "snake-events.bin";
+
+// The custom schedule when pacing.conf is present, else the built-in one
+static Pacing *buildPacing(const Difficulty difficulty,
+                           const unsigned maxScore) {
+  Pacing *custom = loadPacing(pacingPath, maxScore);
+  return custom != NULL ? custom : newPacing(difficulty, maxScore);
+}
+
+// Everything is rewound in place: after hour-long sessions a game-over to
+// new-game transition costs zero allocations
+static void resetGame(Screen *screen, Snake *snake, Grid *grid, Orbs *orbs,
+                      Point *collision) {
+  resetScreen(screen);
+  resetSnake(snake, (Point){screen->mapWidth / 2, screen->mapHeight / 2});
+  gridReset(grid);
+  orbsReset(orbs);
+  gridMark(grid, *snakeHead(snake));
   *collision = (Point){-1, -1};
-  *progress = 0.0;
 }
 
-int main(void) {
+// A fresh board for the unattended demo, dialog-free
+static void demoRound(Screen *screen, Snake *snake, Grid *grid,
+                      Point *collision) {
+  resetGame(screen, snake, grid, screen->orbs, collision);
+  drawWalls(screen);
+  spawnOrb(screen);
+  updateScore(screen, snake->length);
+  drawPoint(screen, *snakeHead(snake), 8);
+  presentFrame(screen);
+}
+
+int main(int argc, char **argv) {
+  // --autopilot runs an unattended demo: the game steers itself and
+  // restarts on its own, only 'q' is listened to.
+  // --metrics dumps the retained frame timings to snake-metrics.csv on
+  // exit; the in-game overlay is toggled with 'm' either way.
+  // --ascii renders single-character cells for dumb terminals.
+  // --log appends a compact binary record of every gameplay event to
+  // snake-events.bin, a native replacement for recording the terminal.
+  bool unattended = false, dumpMetrics = false, logEvents = false;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--autopilot") == 0)
+      unattended = true;
+    else if (strcmp(argv[i], "--metrics") == 0)
+      dumpMetrics = true;
+    else if (strcmp(argv[i], "--ascii") == 0)
+      screenAsciiMode();
+    else if (strcmp(argv[i], "--log") == 0)
+      logEvents = true;
+  }
+
   initializeNcurses();
   init_color(8, 721, 733, 149); // #B8BB26 color for the head of the Snake
 
-  const struct timespec delayMin = {0, 33333333L}, delayMedium = {0, 50000000L},
-                        delayMax = {0, 83333333L},
-                        delayDiff = {0, delayMax.tv_nsec - delayMin.tv_nsec};
   Point collision = {-1, -1};
-  float progress = 0.0;
   Difficulty difficulty = INCREMENTAL;
   bool wallCollision = false;
 
   // Instantiate the objects
   Screen *screen = newScreen();
   Snake *snake = newSnake((Point){screen->mapWidth / 2, screen->mapHeight / 2});
+  Grid *grid = newGrid(screen->mapWidth + 1, screen->mapHeight + 1);
+  screen->grid = grid;
+  Orbs *orbs = newOrbs(grid->width, grid->height);
+  screen->orbs = orbs;
+  Rng rng;
+  rngSeed(&rng, time(NULL));
+  screen->rng = &rng;
+  screenStartRenderer(screen);
+  gridMark(grid, *snakeHead(snake));
+  Autopilot *pilot =
+      unattended ? newAutopilot(grid->width, grid->height) : NULL;
+  Metrics *metrics = newMetrics();
+  InputQueue *input = newInputQueue();
+  EventLog *events = logEvents ? newEventLog(eventsPath) : NULL;
+  Governor *governor = newGovernor();
+  bool overlay = false;
+
+  bool quit = false;
+  // Resume an interrupted session when a snapshot is on disk; otherwise run
+  // the usual welcome dialog and countdown
+  Snake *restored = loadSnapshot(snapshotPath, orbs, &difficulty, &rng,
+                                 screen->mapWidth, screen->mapHeight);
+  if (restored != NULL) {
+    destroySnake(snake);
+    snake = restored;
+    gridReset(grid);
+    // A snapshot taken mid-growth stores one segment fewer than length
+    const unsigned stored = snake->length - snake->growing;
+    for (unsigned i = 0; i < stored; ++i)
+      gridMark(grid, *snakeSegment(snake, i));
+    drawWalls(screen);
+    for (unsigned i = 1; i < stored; ++i)
+      drawPoint(screen, *snakeSegment(snake, i), COLOR_GREEN);
+    drawPoint(screen, *snakeHead(snake), 8);
+    for (int i = 0; i < orbs->count; ++i) {
+      gridMark(grid, orbs->orb[i]);
+      drawPoint(screen, orbs->orb[i], COLOR_MAGENTA);
+    }
+    updateScore(screen, snake->length);
+    presentFrame(screen);
+  } else if (pilot != NULL) { // No dialogs to sit through unattended
+    difficulty = HARD;
+    demoRound(screen, snake, grid, &collision);
+  } else {
+    quit = dialog(screen, WELCOME, &difficulty, 0, (Point){0, 0});
+    if (!quit)
+      quit = prepareGame(screen, snake);
+  }
 
-  bool quit = dialog(screen, WELCOME, &difficulty, 0, (Point){0, 0});
-  if (!quit)
-    quit = prepareGame(screen, snake);
+  if (events != NULL)
+    eventLogRecord(events, EVENT_START, snake->direction, *snakeHead(snake),
+                   snake->length);
 
-  // Main loop
+  // The difficulty is settled now, precompute this game's tick schedule
+  Pacing *pacing = buildPacing(difficulty, screen->playingSurface);
+
+  // Main loop. Each tick has an absolute deadline on the monotonic clock:
+  // the time left after simulating and drawing is spent blocked on input,
+  // so keystrokes are picked up as they arrive and frame pacing does not
+  // drift with how long the tick itself took.
+  long long deadline = metricsNow();
+  unsigned tick = 0;
   while (!quit) {
-    switch (getch()) { // Get keyboard input
+    ++tick;
+    const long long tickStart = metricsNow();
+    // One table read; the whole schedule was precomputed at game start
+    const long long budget = pacingBudget(pacing, snake->length);
+    // Restart pacing when far behind schedule, i.e. after a blocking dialog.
+    // A small overrun instead just shortens the next wait and is absorbed.
+    if (deadline + budget < metricsNow())
+      deadline = metricsNow();
+    deadline += budget;
+
+    bool resized = false;
+    // Sample input for the remainder of the tick. The poll is non-blocking
+    // so the renderer thread is free to use the terminal in between.
+    for (long long remaining = deadline - metricsNow(); remaining > 0;
+         remaining = deadline - metricsNow()) {
+      const int key = screenPollKey(screen);
+      if (key == ERR) { // Nothing pending, nap briefly
+        const struct timespec nap = {0, 1000000L};
+        nanosleep(&nap, NULL);
+        continue;
+      }
+      switch (key) {
+      case 'w':
+      case 'k':
+      case KEY_UP:
+      case 'l':
+      case 'd':
+      case KEY_RIGHT:
+      case 'j':
+      case 's':
+      case KEY_DOWN:
+      case 'h':
+      case 'a':
+      case KEY_LEFT:
+        inputPush(input, key); // Turns wait for their tick
+        break;
+      case KEY_RESIZE:
+        resized = true;
+        break;
+      case 'm': // Toggle the timing overlay
+        overlay = !overlay;
+        if (!overlay)
+          screenStatusLine(screen, "");
+        break;
+      case 'q':
+        quit = true;
+      }
+      if (quit)
+        break;
+    }
+
+    const long long waited = metricsNow(); // Input sampling is over
+
+    if (resized) {
+      // Re-layout in place and repaint once: the game state survives, no
+      // restart. A segment left outside a smaller map is no concern, the
+      // occupancy index and the renderer both ignore out-of-map cells and
+      // the board heals as the body moves on.
+      screenRenderSync(screen);
+      screenResize(screen);
+      gridResize(grid, screen->mapWidth + 1, screen->mapHeight + 1);
+      orbsResize(orbs, grid->width, grid->height);
+      // An eat last tick leaves a growth pending until the next advance();
+      // only the stored segments exist to be re-marked
+      const unsigned stored = snake->length - snake->growing;
+      for (unsigned i = 0; i < stored; ++i)
+        gridMark(grid, *snakeSegment(snake, i));
+      for (int i = 0; i < orbs->count; ++i) {
+        gridMark(grid, orbs->orb[i]);
+        drawPoint(screen, orbs->orb[i], COLOR_MAGENTA);
+      }
+      spawnOrb(screen); // The orb target scales with the new map
+      for (unsigned i = 1; i < stored; ++i)
+        drawPoint(screen, *snakeSegment(snake, i), COLOR_GREEN);
+      drawPoint(screen, *snakeHead(snake), 8);
+      updateScore(screen, snake->length);
+      presentFrame(screen);
+      if (pilot != NULL) { // The planner scratch is keyed to the map size
+        destroyAutopilot(pilot);
+        pilot = newAutopilot(grid->width, grid->height);
+      }
+      destroyPacing(pacing); // The schedule is keyed to it as well
+      pacing = buildPacing(difficulty, screen->playingSurface);
+    }
+
+    // Exactly one queued turn per tick, in arrival order: every key of a
+    // fast multi-tap gets its own tick instead of overwriting the last
+    switch (inputPop(input)) {
     case 'w':
     case 'k':
     case KEY_UP:
@@ -74,71 +273,133 @@ int main(void) {
     case KEY_LEFT:
       changeDirection(snake, WEST);
       break;
-    case 'q':
-      quit = true;
     }
 
+    if (pilot != NULL && orbs->count > 0) // The pilot overrides stray keys
+      changeDirection(snake, autopilotSteer(pilot, grid, snake,
+                                            nearestOrb(orbs, *snakeHead(snake))));
+
     advance(snake);
+    if (events != NULL) // One store per tick, flushed in 32 KiB batches
+      eventLogRecord(events, EVENT_TICK, snake->direction, *snakeHead(snake),
+                     snake->length);
 
-    if (snake->head->pos.x == screen->orb.x && // Check for eaten orb
-        snake->head->pos.y == screen->orb.y) {
+    if (orbAt(orbs, *snakeHead(snake))) { // One lookup however many orbs
+      orbRemove(orbs, *snakeHead(snake));
+      gridClear(grid, *snakeHead(snake)); // The cell is body now, not orb
       snake->growing = true;
       ++snake->length;
       spawnOrb(screen);
       updateScore(screen, snake->length);
-      progress = (float)snake->length / screen->playingSurface;
+      if (events != NULL)
+        eventLogRecord(events, EVENT_ORB, snake->direction, *snakeHead(snake),
+                       snake->length);
 
       if (snake->length == screen->playingSurface) { // Check for win
+        remove(snapshotPath);
+        if (pilot != NULL) { // The demo just rolls into the next game
+          demoRound(screen, snake, grid, &collision);
+          inputClear(input);
+          if (events != NULL)
+            eventLogRecord(events, EVENT_START, snake->direction,
+                           *snakeHead(snake), snake->length);
+          continue;
+        }
         quit = dialog(screen, WIN, &difficulty, snake->length, (Point){0, 0});
-        resetGame(screen, snake, &collision, &progress);
+        resetGame(screen, snake, grid, orbs, &collision);
+        inputClear(input); // Taps meant for the finished game
         if (!quit) {
           quit = dialog(screen, WELCOME, &difficulty, 0, (Point){0, 0});
           if (!quit)
             prepareGame(screen, snake);
         }
-      }
+        destroyPacing(pacing); // The player may have re-picked a difficulty
+        pacing = buildPacing(difficulty, screen->playingSurface);
+        if (events != NULL && !quit)
+          eventLogRecord(events, EVENT_START, snake->direction,
+                         *snakeHead(snake), snake->length);
+      } else // Capturing an orb is the checkpoint worth surviving a crash
+        saveSnapshot(snapshotPath, snake, orbs, difficulty, &rng,
+                     screen->mapWidth, screen->mapHeight);
     }
 
     wallCollision = !insideBoundaries(screen, snake);
-    if (!wallCollision)
+    bool bodyCollision = false;
+    if (!wallCollision) {
+      // Keep the occupancy index in step with the body: the cell the tail
+      // vacated becomes free before asking whether the head ran into the body
+      if (!snake->growing)
+        gridClear(grid, snake->oldTail);
+      if (gridOccupied(grid, *snakeHead(snake))) {
+        bodyCollision = true;
+        collision = *snakeHead(snake);
+      }
+      gridMark(grid, *snakeHead(snake));
       draw(screen, snake);
-    else // Highlight the collision in red
+    } else // Highlight the collision in red
       drawPoint(screen,
-                snake->length > 1 ? snake->head->prev->pos : snake->oldTail,
+                snake->length > 1 ? *snakeNeck(snake) : snake->oldTail,
                 COLOR_RED);
 
-    if ((wallCollision || selfCollision(snake, &collision)) &&
-        !(quit = dialog(screen, OVER, &difficulty, snake->length, collision))) {
-      resetGame(screen, snake, &collision, &progress);
-      prepareGame(screen, snake);
+    const long long simulated = metricsNow();
+    // Shed level 1 and above batches two ticks per emission; the skipped
+    // tick's cells stay queued and go out with the next one
+    if (screen->shedLevel == 0 || (tick & 1) == 0)
+      presentFrame(screen);
+    const long long rendered = metricsNow();
+    metricsRecord(metrics, (FrameSample){.waitNs = waited - tickStart,
+                                         .simulateNs = simulated - waited,
+                                         .renderNs = rendered - simulated,
+                                         .totalNs = rendered - tickStart,
+                                         .budgetNs = budget,
+                                         .length = snake->length});
+    // The governor only ever touches renderer work; the simulation keeps
+    // its deadline schedule whatever the level
+    screen->shedLevel = governorUpdate(governor, rendered - waited, budget);
+    if (overlay && metrics->count % 32 == 0) {
+      char line[128];
+      snprintf(line, sizeof(line),
+               "tick p50 %.1fms p99 %.1fms | work p95 %.2fms p99 %.2fms",
+               metricsPercentile(metrics, 50) / 1e6,
+               metricsPercentile(metrics, 99) / 1e6,
+               metricsWorkPercentile(metrics, 95) / 1e6,
+               metricsWorkPercentile(metrics, 99) / 1e6);
+      screenStatusLine(screen, line);
     }
 
-    switch (difficulty) {
-    case INCREMENTAL: {
-      long usecs = (delayMax.tv_nsec - (unsigned)(delayDiff.tv_nsec * progress)) / 1000.0;
-      const struct timespec delayIncrement = {
-          0, usecs};
-      usleep(usecs);
-      //thrd_sleep(&delayIncrement, NULL);
-      break;
-    }
-    case EASY:
-      usleep(delayMax.tv_nsec / 1000.0);
-      //thrd_sleep(&delayMax, NULL); // 12 fps
-      break;
-    case MEDIUM:
-      usleep(delayMedium.tv_nsec / 1000.0);
-      //thrd_sleep(&delayMedium, NULL); // 20 fps
-      break;
-    case HARD:
-      usleep(delayMin.tv_nsec / 1000.0);
-      //thrd_sleep(&delayMin, NULL); // 30 fps
-      break;
+    if (wallCollision || bodyCollision) {
+      remove(snapshotPath); // A lost game is not worth resuming
+      if (events != NULL)
+        eventLogRecord(events, EVENT_OVER, snake->direction, collision,
+                       snake->length);
+      if (pilot != NULL) { // The demo just rolls into the next game
+        demoRound(screen, snake, grid, &collision);
+      } else if (!(quit = dialog(screen, OVER, &difficulty, snake->length,
+                                 collision))) {
+        resetGame(screen, snake, grid, orbs, &collision);
+        prepareGame(screen, snake);
+        destroyPacing(pacing); // The dialog may have changed the difficulty
+        pacing = buildPacing(difficulty, screen->playingSurface);
+      }
+      inputClear(input); // Taps meant for the finished game
+      if (events != NULL && !quit)
+        eventLogRecord(events, EVENT_START, snake->direction,
+                       *snakeHead(snake), snake->length);
     }
   }
 
+  if (dumpMetrics)
+    metricsDumpCsv(metrics, "snake-metrics.csv");
+  destroyMetrics(metrics);
+  destroyEventLog(events);
+  destroyGovernor(governor);
+  destroyInputQueue(input);
+  destroyPacing(pacing);
+  destroyAutopilot(pilot);
   destroySnake(snake);
   destroyScreen(screen);
+  destroyGrid(grid);
+  destroyOrbs(orbs);
   endwin();
   exit(0);
 }
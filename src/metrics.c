@@ -0,0 +1,92 @@
+/* metrics.c -- Implementation of the class Metrics
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "metrics.h"
+
+Metrics *newMetrics(void) {
+  Metrics *self = malloc(sizeof(Metrics));
+  self->count = 0;
+  return self;
+}
+
+void destroyMetrics(Metrics *self) { free(self); }
+
+long long metricsNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+void metricsRecord(Metrics *self, const FrameSample sample) {
+  self->frame[self->count & (METRICS_FRAMES - 1)] = sample;
+  ++self->count;
+}
+
+// How many ticks the ring currently holds
+static unsigned retained(const Metrics *self) {
+  return self->count < METRICS_FRAMES ? self->count : METRICS_FRAMES;
+}
+
+static int compareNanos(const void *left, const void *right) {
+  const long long a = *(const long long *)left, b = *(const long long *)right;
+  return (a > b) - (a < b);
+}
+
+// The p-th percentile of the durations picked out of each retained tick
+static long long percentileOf(const Metrics *self, const int p,
+                              const bool workOnly) {
+  const unsigned count = retained(self);
+  if (count == 0)
+    return 0;
+  long long scratch[METRICS_FRAMES];
+  for (unsigned i = 0; i < count; ++i) {
+    const FrameSample *sample = self->frame + i;
+    scratch[i] = workOnly ? sample->simulateNs + sample->renderNs
+                          : sample->totalNs;
+  }
+  qsort(scratch, count, sizeof(long long), compareNanos);
+  return scratch[(count - 1) * p / 100];
+}
+
+long long metricsPercentile(const Metrics *self, const int p) {
+  return percentileOf(self, p, false);
+}
+
+long long metricsWorkPercentile(const Metrics *self, const int p) {
+  return percentileOf(self, p, true);
+}
+
+bool metricsDumpCsv(const Metrics *self, const char *path) {
+  FILE *file = fopen(path, "w");
+  if (file == NULL)
+    return false;
+  fputs("frame,wait_ns,simulate_ns,render_ns,total_ns,budget_ns,length\n",
+        file);
+
+  // Oldest retained tick first
+  const unsigned count = retained(self);
+  const unsigned first = self->count - count;
+  for (unsigned i = 0; i < count; ++i) {
+    const FrameSample *sample =
+        self->frame + ((first + i) & (METRICS_FRAMES - 1));
+    fprintf(file, "%u,%lld,%lld,%lld,%lld,%lld,%u\n", first + i,
+            sample->waitNs, sample->simulateNs, sample->renderNs,
+            sample->totalNs, sample->budgetNs, sample->length);
+  }
+  return fclose(file) == 0;
+}
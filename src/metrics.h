@@ -0,0 +1,60 @@
+/* metrics.h -- Interface of the class Metrics
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+
+// One tick of the game loop, phase durations in nanoseconds
+typedef struct frameSample {
+  long long waitNs;     // Spent blocked on input until the deadline
+  long long simulateNs; // advance, collision and orb bookkeeping
+  long long renderNs;   // draw and frame handoff
+  long long totalNs;    // The whole tick, wall clock
+  long long budgetNs;   // What the pacing schedule allotted this tick
+  unsigned length;      // Snake length, to correlate cost with size
+} FrameSample;
+
+// How many of the most recent ticks are retained, a power of two
+#define METRICS_FRAMES 1024
+
+// A ring of the last METRICS_FRAMES ticks. Recording is two clock reads
+// per phase and one store per tick, cheap enough to leave always on;
+// aggregation only happens when the overlay refreshes or on the final
+// CSV dump.
+typedef struct metrics {
+  FrameSample frame[METRICS_FRAMES];
+  unsigned count; // Ticks recorded overall, ring index is count masked
+} Metrics;
+
+Metrics *newMetrics(void);
+void destroyMetrics(Metrics *self);
+
+// The current CLOCK_MONOTONIC time in nanoseconds
+long long metricsNow(void);
+
+void metricsRecord(Metrics *self, const FrameSample sample);
+
+// The p-th percentile of whole-tick time over the retained window
+long long metricsPercentile(const Metrics *self, const int p);
+
+// Same but for the working part of the tick, simulate plus render
+long long metricsWorkPercentile(const Metrics *self, const int p);
+
+// One row per retained tick. Returns false when the file cannot be
+// written.
+bool metricsDumpCsv(const Metrics *self, const char *path);
+
+#endif // !METRICS_H
@@ -0,0 +1,121 @@
+/* orbs.c -- Implementation of the class Orbs
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "orbs.h"
+
+static int cellIndex(const Orbs *self, const Point pos) {
+  return pos.y * self->width + pos.x;
+}
+
+static int wordCount(const int cells) { return (cells + 63) / 64; }
+
+static bool testBit(const Orbs *self, const int index) {
+  return (self->cell[index >> 6] >> (index & 63)) & 1;
+}
+
+Orbs *newOrbs(const int width, const int height) {
+  Orbs *self = malloc(sizeof(Orbs));
+  self->width = width;
+  self->height = height;
+  self->cell = malloc(sizeof(unsigned long long[wordCount(width * height)]));
+  self->orb = malloc(sizeof(Point[width * height]));
+  self->slot = malloc(sizeof(int[width * height]));
+  orbsReset(self);
+  return self;
+}
+
+void destroyOrbs(Orbs *self) {
+  if (self != NULL) {
+    free(self->cell);
+    free(self->orb);
+    free(self->slot);
+    free(self);
+    self = NULL;
+  }
+}
+
+bool orbAt(const Orbs *self, const Point pos) {
+  if (pos.x < 0 || pos.x >= self->width || pos.y < 0 || pos.y >= self->height)
+    return false;
+  return testBit(self, cellIndex(self, pos));
+}
+
+void orbAdd(Orbs *self, const Point pos) {
+  // A position outside the map (a corrupt snapshot) holds no orb; dropping
+  // it here keeps cellIndex() in bounds and spawnOrb() tops the count up
+  if (pos.x < 0 || pos.x >= self->width || pos.y < 0 || pos.y >= self->height)
+    return;
+  const int index = cellIndex(self, pos);
+  if (testBit(self, index))
+    return;
+  self->cell[index >> 6] |= 1ULL << (index & 63);
+  self->orb[self->count] = pos;
+  self->slot[index] = self->count++;
+}
+
+void orbRemove(Orbs *self, const Point pos) {
+  const int index = cellIndex(self, pos);
+  if (!testBit(self, index))
+    return;
+  self->cell[index >> 6] &= ~(1ULL << (index & 63));
+
+  // Swap-remove the orb from the dense list
+  const Point last = self->orb[--self->count];
+  self->orb[self->slot[index]] = last;
+  self->slot[cellIndex(self, last)] = self->slot[index];
+  self->slot[index] = -1;
+}
+
+void orbsResize(Orbs *self, const int width, const int height) {
+  const int count = self->count;
+  Point *kept = malloc(sizeof(Point[count > 0 ? count : 1]));
+  memcpy(kept, self->orb, sizeof(Point[count]));
+
+  self->width = width;
+  self->height = height;
+  self->cell = realloc(self->cell,
+                       sizeof(unsigned long long[wordCount(width * height)]));
+  self->orb = realloc(self->orb, sizeof(Point[width * height]));
+  self->slot = realloc(self->slot, sizeof(int[width * height]));
+  orbsReset(self);
+
+  for (int i = 0; i < count; ++i)
+    if (kept[i].x < width && kept[i].y < height)
+      orbAdd(self, kept[i]);
+  free(kept);
+}
+
+void orbsReset(Orbs *self) {
+  memset(self->cell, 0,
+         sizeof(unsigned long long[wordCount(self->width * self->height)]));
+  memset(self->slot, -1, sizeof(int[self->width * self->height]));
+  self->count = 0;
+}
+
+Point nearestOrb(const Orbs *self, const Point from) {
+  Point best = self->orb[0];
+  int bestDistance = abs(best.x - from.x) + abs(best.y - from.y);
+  for (int i = 1; i < self->count; ++i) {
+    const Point orb = self->orb[i];
+    const int distance = abs(orb.x - from.x) + abs(orb.y - from.y);
+    if (distance < bestDistance) {
+      bestDistance = distance;
+      best = orb;
+    }
+  }
+  return best;
+}
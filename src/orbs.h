@@ -0,0 +1,51 @@
+/* orbs.h -- Interface of the class Orbs
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#ifndef ORBS_H
+#define ORBS_H
+
+#include <stdbool.h>
+
+#include "snake.h" // For Point
+
+// The set of orbs on the map. Membership is one bit per cell, so asking
+// whether the head just ate is a single lookup however many orbs there
+// are; the dense list beside it gives O(1) add and remove and something
+// to iterate when drawing or picking a target.
+typedef struct orbs {
+  int width, height;        // Same geometry as the Grid
+  unsigned long long *cell; // Membership bit per map cell
+  Point *orb;               // The live orbs, densely packed
+  int *slot;                // Cell index -> position in orb, -1 if absent
+  int count;
+} Orbs;
+
+Orbs *newOrbs(const int width, const int height);
+void destroyOrbs(Orbs *self);
+
+// Whether an orb sits on pos. Out-of-map positions hold no orb.
+bool orbAt(const Orbs *self, const Point pos);
+
+// Adopt a new geometry after a terminal resize: one realloc per flat
+// array, keeping every orb that still fits on the map
+void orbsResize(Orbs *self, const int width, const int height);
+
+void orbAdd(Orbs *self, const Point pos);
+void orbRemove(Orbs *self, const Point pos);
+void orbsReset(Orbs *self);
+
+// The orb closest to from by manhattan distance. Meaningless when empty.
+Point nearestOrb(const Orbs *self, const Point from);
+
+#endif // !ORBS_H
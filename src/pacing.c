@@ -0,0 +1,109 @@
+/* pacing.c -- Implementation of the class Pacing
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pacing.h"
+
+static const long long budgetMin = 33333333LL;    // 30 fps, HARD
+static const long long budgetMedium = 50000000LL; // 20 fps
+static const long long budgetMax = 83333333LL;    // 12 fps, EASY
+
+// At most this many control points in a config file
+#define PACING_POINTS 64
+
+static Pacing *emptyPacing(const unsigned maxScore) {
+  Pacing *self = malloc(sizeof(Pacing));
+  self->entries = maxScore + 1;
+  self->budget = malloc(sizeof(long long[self->entries]));
+  return self;
+}
+
+Pacing *newPacing(const Difficulty difficulty, const unsigned maxScore) {
+  Pacing *self = emptyPacing(maxScore);
+  // A degenerate terminal can compute a zero-cell map; the ramp then has
+  // no span to divide over and the single entry is the starting budget
+  const unsigned span = maxScore > 0 ? maxScore : 1;
+  for (unsigned score = 0; score < self->entries; ++score)
+    switch (difficulty) {
+    case INCREMENTAL: // The same line tickBudget() used to refloat per frame
+      self->budget[score] =
+          budgetMax - (budgetMax - budgetMin) * score / span;
+      break;
+    case EASY:
+      self->budget[score] = budgetMax;
+      break;
+    case MEDIUM:
+      self->budget[score] = budgetMedium;
+      break;
+    default:
+      self->budget[score] = budgetMin; // HARD
+    }
+  return self;
+}
+
+void destroyPacing(Pacing *self) {
+  if (self != NULL) {
+    free(self->budget);
+    free(self);
+  }
+}
+
+Pacing *loadPacing(const char *path, const unsigned maxScore) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL)
+    return NULL;
+
+  unsigned score[PACING_POINTS];
+  long long nanos[PACING_POINTS];
+  int points = 0;
+  char line[128];
+  while (fgets(line, sizeof(line), file) != NULL) {
+    if (line[0] == '#' || line[0] == '\n')
+      continue;
+    if (points == PACING_POINTS ||
+        sscanf(line, "%u %lld", &score[points], &nanos[points]) != 2 ||
+        nanos[points] <= 0 ||
+        (points > 0 && score[points] <= score[points - 1])) {
+      fclose(file);
+      return NULL; // Malformed, fall back to the built-in schedule
+    }
+    ++points;
+  }
+  fclose(file);
+  if (points == 0 || score[0] != 0)
+    return NULL;
+
+  // Piecewise-linear between control points, flat past the last one
+  Pacing *self = emptyPacing(maxScore);
+  int segment = 0;
+  for (unsigned s = 0; s < self->entries; ++s) {
+    while (segment + 1 < points && score[segment + 1] <= s)
+      ++segment;
+    if (segment + 1 == points || s <= score[segment])
+      self->budget[s] = nanos[segment];
+    else {
+      const unsigned span = score[segment + 1] - score[segment];
+      self->budget[s] =
+          nanos[segment] + (nanos[segment + 1] - nanos[segment]) *
+                               (long long)(s - score[segment]) / span;
+    }
+  }
+  return self;
+}
+
+long long pacingBudget(const Pacing *self, const unsigned score) {
+  return self->budget[score < self->entries ? score : self->entries - 1];
+}
@@ -0,0 +1,50 @@
+/* pacing.h -- Interface of the class Pacing
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#ifndef PACING_H
+#define PACING_H
+
+#include "screen.h" // For Difficulty
+
+// The tick-duration schedule for one game, precomputed at game start:
+// one budget in nanoseconds per reachable score, so the loop does a
+// single table read per tick instead of float interpolation. A fixed
+// table also makes tournament pacing reproducible and tunable.
+typedef struct pacing {
+  long long *budget; // Nanoseconds per tick, indexed by score
+  unsigned entries;  // maxScore + 1
+} Pacing;
+
+// The built-in schedule: INCREMENTAL descends linearly from the EASY
+// budget (12 fps) at score 0 to the HARD one (30 fps) at maxScore; the
+// other difficulties are flat.
+Pacing *newPacing(const Difficulty difficulty, const unsigned maxScore);
+void destroyPacing(Pacing *self);
+
+/* A custom curve from a config file, NULL when the file is missing or
+ * malformed. The format is one "score budget_ns" control point per line,
+ * scores ascending from 0, '#' starting a comment:
+ *
+ *     # frantic tournament curve
+ *     0 60000000
+ *     30 25000000
+ *
+ * The schedule interpolates linearly between points and holds the last
+ * budget beyond the final one. */
+Pacing *loadPacing(const char *path, const unsigned maxScore);
+
+// The tick budget at score, clamped to the end of the schedule
+long long pacingBudget(const Pacing *self, const unsigned score);
+
+#endif // !PACING_H
@@ -0,0 +1,117 @@
+/* replay.c -- Implementation of the class Replay
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "replay.h"
+
+// On-disk layout: header then count packed events
+#define REPLAY_MAGIC "SNKR"
+#define REPLAY_VERSION 1u
+
+typedef struct replayHeader {
+  char magic[4];
+  unsigned version;
+  int width, height;
+  unsigned seed;
+  unsigned count;
+} ReplayHeader;
+
+Replay *newReplay(const int width, const int height, const unsigned seed) {
+  Replay *self = malloc(sizeof(Replay));
+  self->width = width;
+  self->height = height;
+  self->seed = seed;
+  self->capacity = 64;
+  self->event = malloc(sizeof(ReplayEvent[self->capacity]));
+  self->count = 0;
+  self->cursor = 0;
+  return self;
+}
+
+void destroyReplay(Replay *self) {
+  if (self != NULL) {
+    free(self->event);
+    free(self);
+    self = NULL;
+  }
+}
+
+void replayRecord(Replay *self, const unsigned tick,
+                  const Direction direction) {
+  if (self->count == self->capacity) {
+    self->capacity *= 2;
+    self->event = realloc(self->event, sizeof(ReplayEvent[self->capacity]));
+  }
+  self->event[self->count++] =
+      (ReplayEvent){.tick = tick, .direction = direction};
+}
+
+int replayNext(Replay *self, const unsigned tick) {
+  if (self->cursor == self->count || self->event[self->cursor].tick != tick)
+    return -1;
+  return self->event[self->cursor++].direction;
+}
+
+void replayRewind(Replay *self) { self->cursor = 0; }
+
+bool replaySave(const Replay *self, const char *path) {
+  FILE *file = fopen(path, "wb");
+  if (file == NULL)
+    return false;
+
+  ReplayHeader header = {.version = REPLAY_VERSION,
+                         .width = self->width,
+                         .height = self->height,
+                         .seed = self->seed,
+                         .count = self->count};
+  memcpy(header.magic, REPLAY_MAGIC, sizeof(header.magic));
+
+  const bool ok =
+      fwrite(&header, sizeof(header), 1, file) == 1 &&
+      (self->count == 0 ||
+       fwrite(self->event, sizeof(ReplayEvent), self->count, file) ==
+           self->count);
+  return fclose(file) == 0 && ok;
+}
+
+Replay *loadReplay(const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL)
+    return NULL;
+
+  ReplayHeader header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      memcmp(header.magic, REPLAY_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != REPLAY_VERSION) {
+    fclose(file);
+    return NULL;
+  }
+
+  Replay *self = newReplay(header.width, header.height, header.seed);
+  free(self->event);
+  self->capacity = header.count > 0 ? header.count : 1;
+  self->event = malloc(sizeof(ReplayEvent[self->capacity]));
+  self->count = header.count;
+  if (fread(self->event, sizeof(ReplayEvent), header.count, file) !=
+      header.count) {
+    fclose(file);
+    destroyReplay(self);
+    return NULL;
+  }
+  fclose(file);
+  return self;
+}
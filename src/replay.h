@@ -0,0 +1,57 @@
+/* replay.h -- Interface of the class Replay
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdbool.h>
+
+#include "snake.h"
+
+// A direction change and the tick it was requested on
+typedef struct replayEvent {
+  unsigned tick;
+  unsigned char direction;
+} ReplayEvent;
+
+// A recorded game: map dimensions, RNG seed and every direction change.
+// Together they are enough to re-execute the game tick for tick, which
+// makes any run a fixed workload for benchmarking and regression testing.
+typedef struct replay {
+  int width, height; // Dimensions of the map the game was played on
+  unsigned seed;
+  ReplayEvent *event;
+  unsigned count, capacity;
+  unsigned cursor; // Next event to be handed out during playback
+} Replay;
+
+Replay *newReplay(const int width, const int height, const unsigned seed);
+void destroyReplay(Replay *self);
+
+// Append a direction change requested on the given tick
+void replayRecord(Replay *self, const unsigned tick, const Direction direction);
+
+// The direction recorded for the given tick, or -1 when there is none.
+// Ticks must be queried in nondecreasing order.
+int replayNext(Replay *self, const unsigned tick);
+
+// Rewind playback to the first event
+void replayRewind(Replay *self);
+
+bool replaySave(const Replay *self, const char *path);
+
+// Load a trace written by replaySave(), NULL on failure
+Replay *loadReplay(const char *path);
+
+#endif // !REPLAY_H
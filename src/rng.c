@@ -0,0 +1,28 @@
+/* rng.c -- Implementation of the class Rng
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include "rng.h"
+
+void rngSeed(Rng *self, const unsigned seed) {
+  self->state = seed != 0 ? seed : 1; // xorshift must not start from zero
+}
+
+unsigned rngBelow(Rng *self, const unsigned bound) {
+  unsigned x = self->state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  self->state = x;
+  return x % bound;
+}
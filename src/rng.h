@@ -0,0 +1,30 @@
+/* rng.h -- Interface of the class Rng
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#ifndef RNG_H
+#define RNG_H
+
+// Deterministic pseudorandom generator (xorshift32). The same seed yields
+// the same stream on every platform, unlike rand(), so two runs of a game
+// with equal seeds and inputs are identical tick for tick.
+typedef struct rng {
+  unsigned state;
+} Rng;
+
+void rngSeed(Rng *self, const unsigned seed);
+
+// A uniformly distributed integer in [0, bound), bound > 0
+unsigned rngBelow(Rng *self, const unsigned bound);
+
+#endif // !RNG_H
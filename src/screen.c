@@ -12,47 +12,156 @@
  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
  * GNU General Public License for more details. */
 
-#include <unistd.h>
 #include <locale.h>
+#define NCURSES_WIDECHAR 1 // For the precomposed cchar_t cell writer
 #include <ncurses.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
 
+#include "metrics.h"
 #include "screen.h"
 #include "snake.h"
 
+// A shown color of CELL_BLANK means the cell holds spaces, CELL_UNKNOWN that
+// whatever is on the terminal there cannot be trusted and must be rewritten
+#define CELL_BLANK (-1)
+#define CELL_UNKNOWN (-2)
+
+// How many terminal columns one map cell occupies: 2 in the default wide
+// mode ("██"), 1 in ASCII mode. Fixed by screenAsciiMode() before the
+// Screen exists, so every layout computation below can treat it as a
+// constant and no per-cell code ever branches on the mode.
+static int cellWidth = 2;
+
+void screenAsciiMode(void) { cellWidth = 1; }
+
 Screen *newScreen(void) {
   Screen *self = malloc(sizeof(Screen));
 
   self->width = getmaxx(stdscr) - 1;
   self->height = getmaxy(stdscr) - 1;
-  self->mapWidth = self->width / 4; // Further down is explained why 4
+  // Half the columns when a cell is two columns wide; see translate()
+  self->mapWidth = self->width / (cellWidth * 2);
   self->mapHeight = self->height * 2 / 3;
   self->playingSurface = self->mapWidth * self->mapHeight;
 
-  self->offset = (Point){(self->width - self->mapWidth * 2) / 2,
+  self->offset = (Point){(self->width - self->mapWidth * cellWidth) / 2,
                          (self->height - self->mapHeight) / 2};
 
-  self->grid = malloc(sizeof(int * [self->mapHeight + 1]));
-  for (int i = 0; i <= self->mapHeight; ++i)
-    self->grid[i] = calloc(self->mapWidth + 1, sizeof(int));
+  self->grid = NULL; // Attached by the game state
+  self->rng = NULL;  // Likewise
+  self->orbs = NULL;
+  // Dozens on a big map so the endgame is not a hunt for one pixel
+  self->orbTarget = self->playingSurface / 200 + 1;
+
+  const int cells = (self->mapWidth + 1) * (self->mapHeight + 1);
+  self->cellCapacity = cells;
+  self->shedLevel = 0;
+  self->dirty = malloc(sizeof(Point[cells]));
+  self->dirtyCount = 0;
+  self->shown = malloc(sizeof(int[cells]));
+  self->snapshot = malloc(sizeof(int[cells]));
+  self->repaint = malloc(sizeof(int[cells]));
+  for (int i = 0; i < cells; ++i)
+    self->shown[i] = CELL_UNKNOWN;
+  self->scoreShown[0] = '\0';
+  self->scoreDirty = false;
+
+  self->threaded = false;
+  self->stopRenderer = false;
+  self->repaintAll = false;
+  self->rendering = false;
+  self->frameHead = self->frameTail = 0;
+  pthread_mutex_init(&self->queueLock, NULL);
+  pthread_mutex_init(&self->cursesLock, NULL);
+  pthread_cond_init(&self->wakeRenderer, NULL);
+  pthread_cond_init(&self->rendererIdle, NULL);
 
   return self;
 }
 
 void destroyScreen(Screen *self) {
   if (self != NULL) {
-    if (self->grid != NULL) {
-      for (int i = 0; i <= self->mapHeight; ++i)
-        free(self->grid[i]);
-      free(self->grid);
+    if (self->threaded) {
+      pthread_mutex_lock(&self->queueLock);
+      self->stopRenderer = true;
+      pthread_cond_signal(&self->wakeRenderer);
+      pthread_mutex_unlock(&self->queueLock);
+      pthread_join(self->renderer, NULL);
     }
+    pthread_mutex_destroy(&self->queueLock);
+    pthread_mutex_destroy(&self->cursesLock);
+    pthread_cond_destroy(&self->wakeRenderer);
+    pthread_cond_destroy(&self->rendererIdle);
+    free(self->dirty);
+    free(self->shown);
+    free(self->snapshot);
+    free(self->repaint);
     free(self);
     self = NULL;
   }
 }
 
+// Translate an x coordinate to display on the Screen.
+// This is because two cells are used to display one point: "██". When handling
+// widths and x coordinates half as many as there are on the screen are
+// considered. So when it comes to representing those coordinates it is as if
+// the screen is _one cell yes, the next no, one cell yes, the next no..._
+// █ █ █ █ █ █. To represent x = 4 on the screen x must become 9.
+// In ASCII mode a point is the single character '#' and x maps one to one.
+static int translate(const int x) { return x * cellWidth + 1; }
+
+// Color is one of the eight terminal colors provided by ncurses.
+// COLOR_BLACK = 0 is the current fg color (i.e. actual WHITE)
+static void setColor(const int color) {
+  init_pair(color, color, -1);
+  attrset(COLOR_PAIR(color));
+}
+
+// Cell glyphs precomposed once at startup: a map cell is "██", written as
+// two wide characters with the color pair already baked into the cchar_t,
+// so emitting a cell is two direct curses buffer stores with no UTF-8
+// decoding or format parsing per call. Index 8 is the head color.
+// ASCII mode precomposes chtype glyphs instead: '#' for the body, 'o' for
+// orbs, one byte per cell on the wire for terminals that render
+// multibyte output slowly.
+static cchar_t blockGlyph[9], blankGlyph;
+static cchar_t wallHighGlyph, wallLowGlyph, wallSideGlyph;
+static chtype asciiGlyph[9], asciiBlank;
+
+// Write the block of color at terminal row y, column x. The writer is
+// picked once when the glyphs are built, so drawing carries no mode branch.
+static void emitWide(const int y, const int x, const int color) {
+  const cchar_t *glyph =
+      color == CELL_BLANK ? &blankGlyph : &blockGlyph[color];
+  move(y, x);
+  add_wch(glyph);
+  add_wch(glyph);
+}
+
+static void emitAscii(const int y, const int x, const int color) {
+  mvaddch(y, x, color == CELL_BLANK ? asciiBlank : asciiGlyph[color]);
+}
+
+static void (*emitBlock)(const int, const int, const int) = emitWide;
+
+static void buildCellGlyphs(void) {
+  for (int color = 0; color <= 8; ++color) {
+    init_pair(color, color, -1);
+    setcchar(&blockGlyph[color], L"█", A_NORMAL, color, NULL);
+    asciiGlyph[color] = (chtype)(color == COLOR_MAGENTA ? 'o' : '#') |
+                        COLOR_PAIR(color);
+  }
+  setcchar(&blankGlyph, L" ", A_NORMAL, 0, NULL);
+  setcchar(&wallHighGlyph, L"▄", A_NORMAL, COLOR_YELLOW, NULL);
+  setcchar(&wallLowGlyph, L"▀", A_NORMAL, COLOR_YELLOW, NULL);
+  setcchar(&wallSideGlyph, L"█", A_NORMAL, COLOR_YELLOW, NULL);
+  asciiBlank = ' ';
+  emitBlock = cellWidth == 1 ? emitAscii : emitWide;
+}
+
 void initializeNcurses(void) {
   setlocale(LC_ALL, ""); // Use the locale of the environment
   initscr();
@@ -64,95 +173,353 @@ void initializeNcurses(void) {
   curs_set(0);              // Make the cursor invisible
   start_color();            // Have some colors
   use_default_colors();
+  buildCellGlyphs();
 }
 
-// Translate an x coordinate to display on the Screen.
-// This is because two cells are used to display one point: "██". When handling
-// widths and x coordinates half as many as there are on the screen are
-// considered. So when it comes to representing those coordinates it is as if
-// the screen is _one cell yes, the next no, one cell yes, the next no..._
-// █ █ █ █ █ █. To represent x = 4 on the screen x must become 9
-static int translate(const int x) { return x + x + 1; }
+// Queue a cell of the map to be emitted by the next presentFrame().
+// Cells already showing the wanted color are skipped.
+static void queueCell(Screen *self, const Point pos, const int color) {
+  // A resize can leave parts of the body outside the map; nothing to show
+  if (pos.x < 0 || pos.x > self->mapWidth || pos.y < 0 ||
+      pos.y > self->mapHeight)
+    return;
+  int *shown = &self->shown[pos.y * (self->mapWidth + 1) + pos.x];
+  if (*shown == color)
+    return;
+  *shown = color;
+  self->dirty[self->dirtyCount++] = pos;
+}
 
-// Color is one of the eight terminal colors provided by ncurses.
-// COLOR_BLACK = 0 is the current fg color (i.e. actual WHITE)
-static void setColor(const int color) {
-  init_pair(color, color, -1);
-  attrset(COLOR_PAIR(color));
+void drawPoint(Screen *self, const Point pos, const int color) {
+  queueCell(self, pos, color);
 }
 
-void drawPoint(const Screen *self, const Point pos, const int color) {
-  setColor(color);
-  mvprintw(pos.y + self->offset.y, translate(pos.x) + self->offset.x, "██");
+// Write one cell into the curses buffer
+static void emitCell(const Screen *self, const Point pos, const int color) {
+  emitBlock(pos.y + self->offset.y, translate(pos.x) + self->offset.x, color);
 }
 
-bool insideBoundaries(const Screen *self, const Snake *snake) {
-  return snake->head->pos.x <= self->mapWidth && snake->head->pos.x >= 0 &&
-         snake->head->pos.y <= self->mapHeight && snake->head->pos.y >= 0;
+void presentFrame(Screen *self) {
+  if (!self->threaded) { // Emit synchronously
+    for (int i = 0; i < self->dirtyCount; ++i)
+      emitCell(self, self->dirty[i],
+               self->shown[self->dirty[i].y * (self->mapWidth + 1) +
+                           self->dirty[i].x]);
+    self->dirtyCount = 0;
+    wnoutrefresh(stdscr);
+    doupdate();
+    return;
+  }
+
+  // Hand the frame to the renderer thread; when the queue is full, drop it
+  // and let a full repaint catch the terminal up later. The snapshot for
+  // that repaint is taken here, on the game thread: queueCell() mutates
+  // shown from this same thread, so the copy can never observe a torn
+  // write, and it is refreshed every tick until the renderer consumes it
+  pthread_mutex_lock(&self->queueLock);
+  const int next = (self->frameTail + 1) % FRAME_QUEUE;
+  if (self->repaintAll || next == self->frameHead ||
+      self->dirtyCount > FRAME_CELLS) {
+    self->repaintAll = true;
+    memcpy(self->snapshot, self->shown,
+           sizeof(int[(self->mapWidth + 1) * (self->mapHeight + 1)]));
+  } else {
+    Frame *frame = &self->frame[self->frameTail];
+    frame->count = self->dirtyCount;
+    for (int i = 0; i < self->dirtyCount; ++i)
+      frame->cell[i] = (RenderCell){
+          .pos = self->dirty[i],
+          .color = self->shown[self->dirty[i].y * (self->mapWidth + 1) +
+                               self->dirty[i].x]};
+    self->frameTail = next;
+  }
+  self->dirtyCount = 0;
+  pthread_cond_signal(&self->wakeRenderer);
+  pthread_mutex_unlock(&self->queueLock);
 }
 
-void spawnOrb(Screen *self) {
-  /* This is a critical point. With a big enough map and when the Snake is
-   * short there is no problem. But when progressing towards the completion of
-   * the game the app will probably stall, trying to randomly get a correct position
-   * for the orb. One solution I thought is creating a dynamic structure that
-   * holds the set of current available Points to choose from to spawn a new orb.
-   * But this is a lot of code and could slow things down anyway. So I will
-   * leave the problem open for now. */
+// Decimal digits of score, most significant first, NUL terminated
+static void formatScore(unsigned score, char *digits) {
+  char reversed[10];
+  int length = 0;
   do {
-    self->orb.x = rand() % (self->mapWidth + 1);
-    self->orb.y = rand() % (self->mapHeight + 1);
-  } while (self->grid[self->orb.y][self->orb.x] == 1);
+    reversed[length++] = '0' + score % 10;
+    score /= 10;
+  } while (score > 0);
+  for (int i = 0; i < length; ++i)
+    digits[i] = reversed[length - 1 - i];
+  digits[length] = '\0';
+}
+
+// Write the digits on the HUD. Caller holds the terminal: cursesLock on
+// the renderer thread, plain ownership on an unthreaded game thread.
+static void emitScore(Screen *self, const char *digits) {
+  setColor(0);
+  if (self->scoreShown[0] == '\0') // New game: the static prefix, once
+    mvprintw(self->offset.y - 2, self->offset.x, "Score: ");
+  // Rewrite only the digit cells that changed; the score never shrinks
+  // within a game, so stale digits cannot be left behind
+  for (int i = 0; digits[i] != '\0'; ++i)
+    if (digits[i] != self->scoreShown[i])
+      mvaddch(self->offset.y - 2, self->offset.x + 7 + i, digits[i]);
+  strcpy(self->scoreShown, digits);
+}
+
+static void *renderLoop(void *screen) {
+  Screen *self = screen;
+  pthread_mutex_lock(&self->queueLock);
+  for (;;) {
+    while (!self->stopRenderer && self->frameHead == self->frameTail &&
+           !self->repaintAll && !self->scoreDirty) {
+      pthread_cond_broadcast(&self->rendererIdle);
+      pthread_cond_wait(&self->wakeRenderer, &self->queueLock);
+    }
+    if (self->stopRenderer)
+      break;
+
+    Frame frame = {.count = 0};
+    const bool full = self->repaintAll;
+    if (full) { // Dropped frames: resend the whole map from the snapshot.
+      // The private copy lets presentFrame() retake the snapshot while
+      // this repaint is still being emitted outside the lock.
+      self->repaintAll = false;
+      memcpy(self->repaint, self->snapshot,
+             sizeof(int[(self->mapWidth + 1) * (self->mapHeight + 1)]));
+      self->frameHead = self->frameTail; // Pending frames are stale now
+    } else if (self->frameHead != self->frameTail) {
+      frame = self->frame[self->frameHead];
+      self->frameHead = (self->frameHead + 1) % FRAME_QUEUE;
+    }
+    char digits[11];
+    const bool scoreUpdate = self->scoreDirty;
+    if (scoreUpdate) { // The digits ride along with whatever frame is due
+      strcpy(digits, self->scorePending);
+      self->scoreDirty = false;
+    }
+    self->rendering = true;
+    pthread_mutex_unlock(&self->queueLock);
+
+    pthread_mutex_lock(&self->cursesLock);
+    if (full) {
+      for (int y = 0; y <= self->mapHeight; ++y)
+        for (int x = 0; x <= self->mapWidth; ++x) {
+          const int color = self->repaint[y * (self->mapWidth + 1) + x];
+          if (color != CELL_UNKNOWN)
+            emitCell(self, (Point){x, y}, color);
+        }
+    } else
+      for (int i = 0; i < frame.count; ++i)
+        emitCell(self, frame.cell[i].pos, frame.cell[i].color);
+    if (scoreUpdate)
+      emitScore(self, digits);
+    wnoutrefresh(stdscr);
+    doupdate();
+    pthread_mutex_unlock(&self->cursesLock);
+
+    pthread_mutex_lock(&self->queueLock);
+    self->rendering = false;
+  }
+  pthread_mutex_unlock(&self->queueLock);
+  return NULL;
+}
+
+void screenStartRenderer(Screen *self) {
+  if (!self->threaded) {
+    self->threaded = true;
+    pthread_create(&self->renderer, NULL, renderLoop, self);
+  }
+}
 
-  drawPoint(self, self->orb, COLOR_MAGENTA);
+void screenRenderSync(Screen *self) {
+  if (!self->threaded)
+    return;
+  pthread_mutex_lock(&self->queueLock);
+  while (self->frameHead != self->frameTail || self->rendering ||
+         self->repaintAll || self->scoreDirty)
+    pthread_cond_wait(&self->rendererIdle, &self->queueLock);
+  pthread_mutex_unlock(&self->queueLock);
 }
 
-void updateScore(const Screen *self, const unsigned score) {
+void screenStatusLine(Screen *self, const char *text) {
+  pthread_mutex_lock(&self->cursesLock);
   setColor(0);
-  mvprintw(self->offset.y - 2, self->offset.x, "Score: %d", score);
+  mvprintw(self->offset.y + self->mapHeight + 2, self->offset.x, "%-*s",
+           self->mapWidth * cellWidth, text);
+  refresh();
+  pthread_mutex_unlock(&self->cursesLock);
+}
+
+int screenPollKey(Screen *self) {
+  // Never queue behind a renderer stuck in doupdate() against a stalled
+  // terminal: report no key instead, the caller's nap loop retries in a
+  // millisecond and the simulation keeps its deadline either way
+  if (pthread_mutex_trylock(&self->cursesLock) != 0)
+    return ERR;
+  timeout(0);
+  const int key = getch();
+  pthread_mutex_unlock(&self->cursesLock);
+  return key;
+}
+
+bool insideBoundaries(const Screen *self, const Snake *snake) {
+  const Point head = snake->cell[snake->head];
+  return head.x <= self->mapWidth && head.x >= 0 &&
+         head.y <= self->mapHeight && head.y >= 0;
+}
+
+void spawnOrb(Screen *self) {
+  // One bounded pick from the free-cell index per orb: orb cells are
+  // marked in the Grid, so no rejection sampling is ever needed and this
+  // stays instant even when the Snake covers most of the map
+  while (self->orbs->count < self->orbTarget && self->grid->freeCount > 0) {
+    const Point orb = gridRandomFree(self->grid, self->rng);
+    orbAdd(self->orbs, orb);
+    gridMark(self->grid, orb);
+    drawPoint(self, orb, COLOR_MAGENTA);
+  }
 }
 
-void drawWalls(const Screen *self) {
-  erase(); // Clean the terminal
-  setColor(COLOR_YELLOW);
+void updateScore(Screen *self, const unsigned score) {
+  char digits[11];
+  formatScore(score, digits);
+
+  if (!self->threaded) { // This thread owns the terminal, write directly
+    emitScore(self, digits);
+    return;
+  }
+
+  // Hand the digits to the renderer like any frame: writing stdscr here
+  // would mean taking cursesLock on every orb, and the game thread must
+  // never wait out a doupdate() stalled on a slow terminal
+  pthread_mutex_lock(&self->queueLock);
+  strcpy(self->scorePending, digits);
+  self->scoreDirty = true;
+  pthread_cond_signal(&self->wakeRenderer);
+  pthread_mutex_unlock(&self->queueLock);
+}
+
+// Both the dialog frames and the doodle bounding box share these dimensions
+static const int dialogHeight = 16, dialogWidth = 57;
+
+// Blank only the rows the game ever touches (map, walls, HUD and dialog)
+// instead of erase()ing the whole terminal, which would force a full-screen
+// repaint on every reset
+static void clearPlayfield(Screen *self) {
+  const int dialogTop = self->offset.y + self->mapHeight / 2 - dialogHeight / 2 + 1;
+  int top = self->offset.y - 2, bottom = self->offset.y + self->mapHeight + 2;
+  if (dialogTop < top)
+    top = dialogTop;
+  if (dialogTop + dialogHeight > bottom)
+    bottom = dialogTop + dialogHeight;
+
+  for (int j = top; j <= bottom; ++j)
+    mvhline(j, 0, ' ', self->width + 1);
+
+  // Nothing of the map or the HUD is on the terminal anymore
+  for (int i = 0; i < (self->mapWidth + 1) * (self->mapHeight + 1); ++i)
+    self->shown[i] = CELL_UNKNOWN;
+  self->dirtyCount = 0;
+  self->scoreShown[0] = '\0';
+}
+
+void drawWalls(Screen *self) {
+  clearPlayfield(self);
 
   const Point northWest = {self->offset.x, self->offset.y - 1},
-              southEasth = {translate(self->mapWidth) + self->offset.x + 2,
+              southEasth = {translate(self->mapWidth) + self->offset.x +
+                                cellWidth,
                             self->mapHeight + self->offset.y + 1};
 
-  for (int i = northWest.x; i <= southEasth.x; ++i) {
-    mvprintw(northWest.y, i, "▄");
-    mvprintw(southEasth.y, i, "▀");
-  }
-  for (int j = northWest.y + 1; j < southEasth.y; ++j) {
-    mvprintw(j, northWest.x, "█");
-    mvprintw(j, southEasth.x, "█");
+  // Each wall is one batched line write of a precomposed glyph. This runs
+  // once per repaint, so a mode branch here costs nothing.
+  const int span = southEasth.x - northWest.x + 1;
+  const int side = southEasth.y - northWest.y - 1;
+  if (cellWidth == 1) {
+    const chtype h = (chtype)'-' | COLOR_PAIR(COLOR_YELLOW),
+                 v = (chtype)'|' | COLOR_PAIR(COLOR_YELLOW);
+    mvhline(northWest.y, northWest.x, h, span);
+    mvhline(southEasth.y, northWest.x, h, span);
+    mvvline(northWest.y + 1, northWest.x, v, side);
+    mvvline(northWest.y + 1, southEasth.x, v, side);
+  } else {
+    mvhline_set(northWest.y, northWest.x, &wallHighGlyph, span);
+    mvhline_set(southEasth.y, northWest.x, &wallLowGlyph, span);
+    mvvline_set(northWest.y + 1, northWest.x, &wallSideGlyph, side);
+    mvvline_set(northWest.y + 1, southEasth.x, &wallSideGlyph, side);
   }
 }
 
-void draw(const Screen *self, Snake *snake) {
-  // Cover the old tail with a blank if the Snake has not grown
-  if (!snake->growing) {
-    mvprintw(snake->oldTail.y + self->offset.y,
-             translate(snake->oldTail.x) + self->offset.x, "  ");
-    self->grid[snake->oldTail.y][snake->oldTail.x] = 0;
+void resetScreen(Screen *self) {
+  screenRenderSync(self); // Nothing stale left in flight
+  pthread_mutex_lock(&self->queueLock);
+  self->frameHead = self->frameTail = 0;
+  self->repaintAll = false;
+  pthread_mutex_unlock(&self->queueLock);
+  self->dirtyCount = 0;
+
+  // The map is about to be repainted; trust nothing currently shown
+  for (int i = 0; i < (self->mapWidth + 1) * (self->mapHeight + 1); ++i)
+    self->shown[i] = CELL_UNKNOWN;
+  self->scoreShown[0] = '\0';
+}
+
+bool screenResize(Screen *self) {
+  const int oldMapWidth = self->mapWidth, oldMapHeight = self->mapHeight;
+
+  // ncurses has already adopted the new terminal size by the time
+  // KEY_RESIZE is delivered, so just re-derive the layout from it
+  self->width = getmaxx(stdscr) - 1;
+  self->height = getmaxy(stdscr) - 1;
+  self->mapWidth = self->width / (cellWidth * 2);
+  self->mapHeight = self->height * 2 / 3;
+  self->playingSurface = self->mapWidth * self->mapHeight;
+  self->offset = (Point){(self->width - self->mapWidth * cellWidth) / 2,
+                         (self->height - self->mapHeight) / 2};
+  self->orbTarget = self->playingSurface / 200 + 1;
+
+  const int cells = (self->mapWidth + 1) * (self->mapHeight + 1);
+  if (cells > self->cellCapacity) { // One realloc each, no per-row churn
+    self->dirty = realloc(self->dirty, sizeof(Point[cells]));
+    self->shown = realloc(self->shown, sizeof(int[cells]));
+    self->snapshot = realloc(self->snapshot, sizeof(int[cells]));
+    self->repaint = realloc(self->repaint, sizeof(int[cells]));
+    self->cellCapacity = cells;
   }
+  self->shedLevel = 0; // The workload changed; let the governor re-measure
+  self->dirtyCount = 0;
 
-  // Draw the new head added by Snake::advance()
-  drawPoint(self, snake->head->pos, 8);
-  if (snake->head->prev != NULL)
-    drawPoint(self, snake->head->prev->pos, COLOR_GREEN);
-  self->grid[snake->head->pos.y][snake->head->pos.x] = 1;
+  // Everything on the terminal moved; blank it and repaint the frame once
+  erase();
+  drawWalls(self);
+  return self->mapWidth != oldMapWidth || self->mapHeight != oldMapHeight;
+}
+
+void draw(Screen *self, Snake *snake) {
+  // Cover the old tail with a blank if the Snake has not grown
+  if (!snake->growing)
+    queueCell(self, snake->oldTail, CELL_BLANK);
+
+  // Draw the new head added by Snake::advance(). Under heavy shedding
+  // the neck keeps the head color until the tail blanks it: the shape
+  // stays correct and the cheapest frame on time beats a pretty one late
+  queueCell(self, *snakeHead(snake), 8);
+  if (self->shedLevel < 2 && snakeNeck(snake) != NULL)
+    queueCell(self, *snakeNeck(snake), COLOR_GREEN);
 }
 
 bool prepareGame(Screen *self, Snake *snake) {
+  screenRenderSync(self); // The game thread owns ncurses from here
   drawWalls(self);
   spawnOrb(self);
-  updateScore(self, snake->length);
-  drawPoint(self, snake->head->pos, 8); // Draw the head of the snake
+  drawPoint(self, *snakeHead(snake), 8); // Draw the head of the snake
   setColor(0);                          // Tip at the bottom
   mvprintw(self->offset.y + self->mapHeight + 2, self->offset.x,
            "Move in any direction to start the game.");
+  // The score wakes the renderer, so it goes last: every direct stdscr
+  // write above must be done before the thread may touch the terminal
+  updateScore(self, snake->length);
+  presentFrame(self); // Flush the queued cells before blocking on input
+  screenRenderSync(self);
 
   nodelay(stdscr, false);
   // Get the initial direction of the snake
@@ -193,56 +560,41 @@ getUserInput:
 
 static void updateDoodle(Snake *doodle, const Point beginDialog,
                          const int dialogHeight, const int dialogWidth) {
-  doodle->oldTail = doodle->tail->pos;
+  doodle->oldTail = *snakeTail(doodle);
   ouroboros(doodle); // Tail becomes the head
-
-  // Head moves forward
-  switch (doodle->direction) {
-  case NORTH:
-    if (doodle->head->pos.y >= beginDialog.y) {
-      --doodle->head->pos.y;
-      break;
-    }
-    doodle->direction = WEST;
-    //    [[fallthrough]];
-  case WEST:
-    if (doodle->head->pos.x > beginDialog.x) {
-      doodle->head->pos.x -= 2;
-      break;
-    }
-    doodle->direction = SOUTH;
-    //    [[fallthrough]];
-  case SOUTH:
-    if (doodle->head->pos.y - 1 < beginDialog.y + dialogHeight) {
-      ++doodle->head->pos.y;
-      break;
-    }
-    doodle->direction = EAST;
-    //    [[fallthrough]];
-  case EAST:
-    if (doodle->head->pos.x < beginDialog.x + dialogWidth - 1) {
-      doodle->head->pos.x += 2;
-      break;
-    }
+  Point *head = snakeHead(doodle);
+
+  // Head moves forward along the dialog border: turn left until a step
+  // from the shared delta table lands inside. Horizontal steps span two
+  // columns because the doodle works in terminal cells and one is "██".
+  bool moved = false;
+  for (int tries = 0; tries < WEST + 1 && !moved; ++tries) {
+    const Point next = movedPoint(
+        *head, doodle->direction,
+        directionDelta[doodle->direction].x != 0 ? cellWidth : 1);
+    if (next.x >= beginDialog.x - 1 && next.x <= beginDialog.x + dialogWidth &&
+        next.y >= beginDialog.y - 1 &&
+        next.y <= beginDialog.y + dialogHeight + 1) {
+      *head = next;
+      moved = true;
+    } else // The left turn, i.e. NORTH to WEST to SOUTH to EAST
+      doodle->direction = (doodle->direction + 3) % (WEST + 1);
+  }
+  if (!moved) { // Cannot happen with a sane dialog, mirror the old fallback
     doodle->direction = NORTH;
-    --doodle->head->pos.y;
+    --head->y;
   }
 
-  // Draw the head, hide the old tail, and sleep
-  setColor(8);
-  mvprintw(doodle->head->pos.y, doodle->head->pos.x, "██");
-  if (doodle->head->prev != NULL) {
-    setColor(COLOR_GREEN);
-    mvprintw(doodle->head->prev->pos.y, doodle->head->prev->pos.x, "██");
-  }
-  mvprintw(doodle->oldTail.y, doodle->oldTail.x, "  ");
-  usleep(33333L);
-  //  thrd_sleep(&(const struct timespec){0, 33333333L}, NULL); // 30 fps
+  // Draw the head and hide the old tail; the caller paces the animation
+  emitBlock(head->y, head->x, 8);
+  if (snakeNeck(doodle) != NULL)
+    emitBlock(snakeNeck(doodle)->y, snakeNeck(doodle)->x, COLOR_GREEN);
+  emitBlock(doodle->oldTail.y, doodle->oldTail.x, CELL_BLANK);
 }
 
 bool dialog(Screen *self, DialogKind kind, Difficulty *difficulty,
             const unsigned score, const Point collision) {
-  static const int dialogHeight = 16, dialogWidth = 57;
+  screenRenderSync(self); // The game thread owns ncurses during dialogs
   const Point begin = {self->offset.x + self->mapWidth - dialogWidth / 2 + 1,
                        self->offset.y + self->mapHeight / 2 - dialogHeight / 2 +
                            1};
@@ -303,25 +655,27 @@ bool dialog(Screen *self, DialogKind kind, Difficulty *difficulty,
   Snake *doodle = NULL; // Snake decoration on welcome screen
   char **fmt;           // Select the appropriate format
   // Add right offset so that changing difficulty doesn't interfere with doodle
-  const int diffFmtX = begin.x + (kind == WELCOME ? 3 : 0);
+  const int diffCol = kind == WELCOME ? 3 : 0;
 
   switch (kind) {
   case WELCOME:
     fmt = welcome;
     doodle = newSnake((Point){begin.x, begin.y + 2});
     doodle->direction = SOUTH;
-    setColor(COLOR_GREEN);
     for (int i = 0; i < 7; ++i) { // Make it long 7
-      doodle->head->next =
-          newNode((Point){begin.x, doodle->head->pos.y + 1}, doodle->head);
-      doodle->head = doodle->head->next;
-      mvprintw(doodle->head->pos.y, doodle->head->pos.x, "██");
+      doodle->growing = true;
+      ++doodle->length;
+      advance(doodle); // Pushes a new head one cell SOUTH
+      emitBlock(snakeHead(doodle)->y, snakeHead(doodle)->x, COLOR_GREEN);
     }
     break;
   case OVER:
     fmt = over;
-    if (collision.x != -1 && collision.y != -1)
+    if (collision.x != -1 && collision.y != -1) {
       drawPoint(self, collision, COLOR_RED);
+      presentFrame(self); // So the red cell is visible under the dialog
+      screenRenderSync(self);
+    }
     // Hide score count above the playing field
     mvhline(self->offset.y - 2, self->offset.x - 1, ' ', self->width);
     nodelay(stdscr, false);
@@ -332,15 +686,36 @@ bool dialog(Screen *self, DialogKind kind, Difficulty *difficulty,
     break;
   }
 
-  // Draw the dialog
+  // The static art of each dialog is composed once per process into an
+  // off-screen pad; only the score digits and the difficulty label are
+  // patched per call. The whole frame then reaches stdscr in one
+  // copywin() blit, so on slow links the dialog appears whole instead of
+  // painting progressively line by line. The pads live until exit.
+  static WINDOW *composed[WIN + 1] = {NULL, NULL, NULL};
+  WINDOW *pad = composed[kind];
+  if (pad == NULL) {
+    pad = composed[kind] = newpad(dialogHeight, dialogWidth);
+    wattrset(pad, COLOR_PAIR(0));
+    for (int i = 0; i < dialogHeight; ++i)
+      if (i != 11 && (kind == WELCOME || i != 9)) // Dynamic lines come later
+        mvwprintw(pad, i, 0, "%s", fmt[i]);
+  }
+  if (kind != WELCOME) // Plug in the score
+    mvwprintw(pad, 9, 0, fmt[9], score);
+  mvwprintw(pad, 11, diffCol, fmt[11], diff[*difficulty]);
   setColor(0);
-  for (int y = begin.y, i = 0; y < begin.y + dialogHeight; ++y, ++i)
-    if (kind != WELCOME && i == 9) // Plug in the score
-      mvprintw(y, begin.x, fmt[i], score);
-    else if (i == 11) // Plug in the difficulty
-      mvprintw(y, diffFmtX, fmt[i], diff[*difficulty]);
-    else
-      mvprintw(y, begin.x, "%s", fmt[i]);
+  copywin(pad, stdscr, 0, 0, begin.y, begin.x, begin.y + dialogHeight - 1,
+          begin.x + dialogWidth - 1, false);
+
+  // The welcome screen runs a timed event loop on the same absolute-
+  // deadline scheme as the main loop: keys are polled with a short
+  // timeout and the doodle advances on its own 30fps deadline, so menu
+  // response never waits behind an animation sleep. The other dialogs
+  // have nothing animating and just block on getch().
+  static const long long doodleBudget = 33333333LL;
+  long long doodleDeadline = metricsNow();
+  if (kind == WELCOME)
+    timeout(5);
 
   while (true) { // Listen for keyboard input
     switch (getch()) {
@@ -353,16 +728,18 @@ bool dialog(Screen *self, DialogKind kind, Difficulty *difficulty,
     case KEY_RIGHT: // increment difficulty
       if (kind != WIN && *difficulty != HARD) {
         ++*difficulty;
-        setColor(0);
-        mvprintw(begin.y + 11, diffFmtX, fmt[11], diff[*difficulty]);
+        mvwprintw(pad, 11, diffCol, fmt[11], diff[*difficulty]);
+        copywin(pad, stdscr, 11, 0, begin.y + 11, begin.x, begin.y + 11,
+                begin.x + dialogWidth - 1, false);
       }
       break;
     case '<':
     case KEY_LEFT: // decrement difficulty
       if (kind != WIN && *difficulty != INCREMENTAL) {
         --*difficulty;
-        setColor(0);
-        mvprintw(begin.y + 11, diffFmtX, fmt[11], diff[*difficulty]);
+        mvwprintw(pad, 11, diffCol, fmt[11], diff[*difficulty]);
+        copywin(pad, stdscr, 11, 0, begin.y + 11, begin.x, begin.y + 11,
+                begin.x + dialogWidth - 1, false);
       }
       break;
     case 'n':
@@ -371,7 +748,11 @@ bool dialog(Screen *self, DialogKind kind, Difficulty *difficulty,
       return true;
     }
 
-    if (kind == WELCOME)
+    if (kind == WELCOME && metricsNow() >= doodleDeadline) {
       updateDoodle(doodle, begin, dialogHeight, dialogWidth);
+      doodleDeadline += doodleBudget;
+      if (doodleDeadline < metricsNow()) // Far behind, restart pacing
+        doodleDeadline = metricsNow() + doodleBudget;
+    }
   }
 }
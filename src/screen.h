@@ -15,43 +15,132 @@
 #ifndef SCREEN_H
 #define SCREEN_H
 
+#include <pthread.h>
 #include <stdbool.h>
 
+#include "grid.h"
+#include "orbs.h"
 #include "snake.h"
 
 typedef enum { INCREMENTAL, EASY, MEDIUM, HARD } Difficulty;
 
+// A cell of the map together with the color it must show
+typedef struct renderCell {
+  Point pos;
+  int color;
+} RenderCell;
+
+// One frame worth of deltas handed to the renderer thread
+#define FRAME_CELLS 8
+#define FRAME_QUEUE 8
+typedef struct frame {
+  RenderCell cell[FRAME_CELLS];
+  int count;
+} Frame;
+
 typedef struct screen {
   int width, height;
   int mapWidth, mapHeight; // The map occupies a fraction of the screen
   int playingSurface;
   Point offset;            // An offset from the top-left for the map
-  Point orb;               // The orb to capture
-  int **grid;              // Keep track of the occupied cells.
+  Orbs *orbs;              // The orbs to capture, borrowed
+  int orbTarget;           // How many orbs spawnOrb() keeps on the map
+  Grid *grid;              // Occupancy index, borrowed from the game state
+  Rng *rng;                // Borrowed from the game state as well
+  Point *dirty;            // Cells touched this frame, emitted in one batch
+  int dirtyCount;
+  int cellCapacity; // Cells the per-cell buffers below can hold
+  int shedLevel; // Renderer work to skip under overrun, set by the governor
+  int *shown; // Color currently on screen for every cell of the map
+  char scoreShown[11]; // Digits currently on the HUD, "" when it is blank
+
+  // Renderer thread state. While the thread runs, presentFrame() only
+  // enqueues the frame delta and the thread emits it, so a stalled terminal
+  // never blocks the simulation; when the queue is full the frame is
+  // dropped and a full repaint from shown is scheduled instead.
+  bool threaded;      // The renderer thread is running
+  bool stopRenderer;  // Ask the thread to exit
+  bool repaintAll;    // Frames were dropped, resend the whole map
+  bool rendering;     // The thread is emitting right now
+  int frameHead, frameTail;
+  Frame frame[FRAME_QUEUE];
+  int *snapshot; // Copy of shown taken in presentFrame() for full repaints
+  int *repaint;  // The renderer's private working copy of snapshot
+  char scorePending[11]; // Digits handed to the renderer by updateScore()
+  bool scoreDirty;       // scorePending awaits emission
+  pthread_t renderer;
+  pthread_mutex_t queueLock;  // Guards the frame queue and the flags above
+  pthread_mutex_t cursesLock; // Guards ncurses calls during gameplay
+  pthread_cond_t wakeRenderer, rendererIdle;
 } Screen;
 
 Screen *newScreen(void);
 void destroyScreen(Screen *self);
 
+// Render every point as the single character '#' ('o' for orbs) instead of
+// the two-column "██": byte-per-cell output for serial consoles and dumb
+// terminals, and twice the playing field from the same columns. Must be
+// called before newScreen(); the mode specializes the cell writer and the
+// layout once, it is not a per-draw branch.
+void screenAsciiMode(void);
+
+// Ready the Screen for a new game on the same terminal without touching
+// any allocation: frames in flight are flushed, the render queue and the
+// shadow state are cleared, and the next drawWalls() repaints everything
+void resetScreen(Screen *self);
+
 void initializeNcurses(void);
 
-void drawWalls(const Screen *self);
+void drawWalls(Screen *self);
+
+// Re-derive the layout after a KEY_RESIZE: map dimensions, offset and the
+// per-cell buffers, regrown with one realloc each, then a single full
+// repaint of walls and HUD. Call screenRenderSync() first. Returns true
+// when the map dimensions changed, so the caller can rebuild what it
+// keys to them.
+bool screenResize(Screen *self);
 
-void updateScore(const Screen *self, const unsigned score);
+// Show the score on the HUD. With the renderer thread running the digits
+// travel with the frame traffic and reach the terminal on its schedule;
+// the game thread never writes stdscr for them.
+void updateScore(Screen *self, const unsigned score);
 
-// Spawn a new orb and show it on the Screen
+// Top the map up to orbTarget orbs and show the new ones on the Screen.
+// Orb cells are marked in the Grid, so each spawn is one draw from the
+// free-cell index with no rejection loop.
 void spawnOrb(Screen *self);
 
 // Check for collisions with the walls
 bool insideBoundaries(const Screen *self, const Snake *snake);
 
 // Draw the Snake on to the Screen
-void draw(const Screen *self, Snake *snake);
+void draw(Screen *self, Snake *snake);
 
 bool prepareGame(Screen *self, Snake *snake);
 
 // Place a colored point ("██") on the map.
-void drawPoint(const Screen *self, const Point pos, const int color);
+// The cell is queued and reaches the terminal on the next presentFrame().
+void drawPoint(Screen *self, const Point pos, const int color);
+
+// Emit every cell queued since the last call in one batched pass, followed
+// by a single refresh. Cells whose color did not change are skipped. With
+// the renderer thread running this only hands the frame over and returns.
+void presentFrame(Screen *self);
+
+// Move frame emission to a dedicated thread fed by presentFrame()
+void screenStartRenderer(Screen *self);
+
+// Block until every queued frame has reached the terminal. Call before
+// touching ncurses directly from the game thread (dialogs, walls).
+void screenRenderSync(Screen *self);
+
+// One line of diagnostics on the tip row under the map, padded so it
+// overwrites whatever was shown there before. Pass "" to blank it.
+void screenStatusLine(Screen *self, const char *text);
+
+// One pending keystroke without blocking, ERR when there is none or the
+// renderer thread is emitting right now; the caller's poll loop retries.
+int screenPollKey(Screen *self);
 
 typedef enum { WELCOME, OVER, WIN } DialogKind;
 
@@ -17,84 +17,203 @@
 
 #include "snake.h"
 
-Node *newNode(const Point spawnPosition, Node *prev) {
-  Node *self = malloc(sizeof(Node));
-  self->pos = spawnPosition;
-  self->prev = prev;
-  self->next = NULL;
-  return self;
+#define INITIAL_CAPACITY 16
+
+const Point directionDelta[WEST + 1] = {
+    {0, -1}, // NORTH
+    {1, 0},  // EAST
+    {0, 1},  // SOUTH
+    {-1, 0}, // WEST
+};
+
+Point movedPoint(const Point pos, const Direction direction,
+                 const int cells) {
+  return (Point){pos.x + directionDelta[direction].x * cells,
+                 pos.y + directionDelta[direction].y * cells};
 }
 
-void destroyNode(Node *self) {
-  if (self != NULL) {
-    free(self);
-    self = NULL;
-  }
+/* Arena of retired cell buffers. Instead of freeing a body on game over and
+ * growing a fresh one from scratch next game, buffers are parked here and
+ * handed back by acquireCells(), so a reset costs no allocator work and a
+ * long-lived process stops fragmenting the heap with body reallocations.
+ * One arena per thread, since parallel runners own one game per worker. */
+#define POOL_SIZE 8
+static _Thread_local struct pooledCells {
+  Point *cell;
+  unsigned capacity;
+} pool[POOL_SIZE];
+static _Thread_local int poolCount = 0;
+
+// A cell buffer of at least wanted capacity, reusing a pooled one if any
+// fits. Sets capacity to the actual size handed out.
+static Point *acquireCells(const unsigned wanted, unsigned *capacity) {
+  for (int i = 0; i < poolCount; ++i)
+    if (pool[i].capacity >= wanted) {
+      Point *cell = pool[i].cell;
+      *capacity = pool[i].capacity;
+      pool[i] = pool[--poolCount];
+      return cell;
+    }
+  *capacity = wanted;
+  return malloc(sizeof(Point[wanted]));
+}
+
+// Park a buffer for reuse, or free it when the arena is full
+static void retireCells(Point *cell, const unsigned capacity) {
+  if (poolCount < POOL_SIZE)
+    pool[poolCount++] =
+        (struct pooledCells){.cell = cell, .capacity = capacity};
+  else
+    free(cell);
+}
+
+// Index of the segment at distance fromHead behind the head, wrapping around
+// the circular buffer
+static unsigned segmentIndex(const Snake *self, const unsigned fromHead) {
+  return (self->head + self->capacity - fromHead) & (self->capacity - 1);
 }
 
 Snake *newSnake(const Point headPosition) {
   Snake *self = malloc(sizeof(Snake));
-  self->tail = self->head = newNode(headPosition, NULL);
+  self->cell = acquireCells(INITIAL_CAPACITY, &self->capacity);
+  self->head = 0;
+  self->cell[self->head] = headPosition;
   self->length = 1;
+  self->growing = false;
   return self;
 }
 
+void resetSnake(Snake *self, const Point headPosition) {
+  // The cell buffer is kept at whatever capacity the last game reached
+  self->length = 1;
+  self->head = 0;
+  self->cell[0] = headPosition;
+  self->oldTail = headPosition;
+  self->growing = false;
+  self->direction = EAST;
+}
+
 void destroySnake(Snake *self) {
   if (self != NULL) {
-    for (Node *it = self->head; it != NULL; it = it->prev)
-      destroyNode(it->next);
-    destroyNode(self->tail);
+    retireCells(self->cell, self->capacity);
     free(self);
     self = NULL;
   }
 }
 
+Point *snakeHead(Snake *self) { return self->cell + self->head; }
+
+// While a growth is pending (the caller bumped length but advance() has
+// not run yet) the ring physically holds one segment fewer than length;
+// indexing must count the stored segments or it lands on a stale slot
+static unsigned storedSegments(const Snake *self) {
+  return self->length - self->growing;
+}
+
+Point *snakeNeck(Snake *self) {
+  return storedSegments(self) > 1 ? self->cell + segmentIndex(self, 1) : NULL;
+}
+
+Point *snakeTail(Snake *self) {
+  return self->cell + segmentIndex(self, storedSegments(self) - 1);
+}
+
+Point *snakeSegment(Snake *self, const unsigned fromHead) {
+  return self->cell + segmentIndex(self, fromHead);
+}
+
+// Double the capacity of the cell buffer, unwrapping the ring so that the
+// segments again sit in one contiguous run from tail to head
+static void grow(Snake *self) {
+  unsigned newCapacity;
+  Point *newCell = acquireCells(self->capacity * 2, &newCapacity);
+  const unsigned tail = segmentIndex(self, self->length - 2);
+  for (unsigned i = 0; i < self->length - 1; ++i)
+    newCell[i] = self->cell[(tail + i) & (self->capacity - 1)];
+  retireCells(self->cell, self->capacity);
+  self->cell = newCell;
+  self->capacity = newCapacity;
+  self->head = self->length - 2;
+}
+
+void snakeCoordinates(const Snake *self, int *x, int *y) {
+  // The ring holds the body in at most two contiguous runs, tail to head
+  const unsigned mask = self->capacity - 1;
+  const unsigned tail =
+      (self->head + self->capacity - (self->length - 1)) & mask;
+  const unsigned firstRun =
+      tail <= self->head ? self->length : self->capacity - tail;
+  unsigned out = 0;
+  for (unsigned i = 0; i < firstRun; ++i, ++out) {
+    x[out] = self->cell[tail + i].x;
+    y[out] = self->cell[tail + i].y;
+  }
+  for (unsigned i = 0; out < self->length; ++i, ++out) {
+    x[out] = self->cell[i].x;
+    y[out] = self->cell[i].y;
+  }
+}
+
+unsigned pointMatches(const int *x, const int *y, const unsigned count,
+                      const Point pos, int *first) {
+  // The count sweep carries no branch, so it compiles to packed compares
+  unsigned hits = 0;
+  for (unsigned i = 0; i < count; ++i)
+    hits += (x[i] == pos.x) & (y[i] == pos.y);
+
+  if (first != NULL) {
+    *first = -1;
+    if (hits > 0)
+      for (unsigned i = 0; i < count; ++i)
+        if (x[i] == pos.x && y[i] == pos.y) {
+          *first = i;
+          break;
+        }
+  }
+  return hits;
+}
+
 bool selfCollision(const Snake *self, Point *collision) {
-  for (Node *it1 = self->head; it1 != NULL; it1 = it1->prev)
-    for (Node *it2 = it1->prev; it2 != NULL; it2 = it2->prev)
-      if (it1->pos.x == it2->pos.x && it1->pos.y == it2->pos.y) {
-        if (collision != NULL)
-          *collision = it1->pos;
-        return true;
-      }
-  return false;
+  // SoA scratch reused across calls; the gather is two straight copies
+  static _Thread_local int *x = NULL, *y = NULL;
+  static _Thread_local unsigned scratch = 0;
+  if (scratch < self->capacity) {
+    scratch = self->capacity;
+    x = realloc(x, sizeof(int[scratch]));
+    y = realloc(y, sizeof(int[scratch]));
+  }
+  snakeCoordinates(self, x, y);
+
+  // The first length - 1 entries are the body behind the head
+  if (pointMatches(x, y, self->length - 1, self->cell[self->head], NULL) ==
+      0)
+    return false;
+  if (collision != NULL)
+    *collision = self->cell[self->head];
+  return true;
 }
 
 void ouroboros(Snake *self) {
-  self->head->next = self->tail;
-  self->tail = self->tail->next;
-  self->tail->prev = NULL;
-
-  *self->head->next =
-      (Node){.next = NULL, .prev = self->head, .pos = self->head->pos};
-  self->head = self->head->next;
+  const Point head = self->cell[self->head];
+  self->head = (self->head + 1) & (self->capacity - 1);
+  self->cell[self->head] = head;
 }
 
 void advance(Snake *self) {
   if (!self->growing)
-    self->oldTail = self->tail->pos;
+    self->oldTail = *snakeTail(self);
 
   if (self->growing) {
     self->growing = false;
-    self->head = self->head->next = newNode(self->head->pos, self->head);
+    if (self->length > self->capacity) // length was bumped by the caller
+      grow(self);
+    ouroboros(self); // The head is duplicated, lengthening the body
   } else if (self->length > 1)
     ouroboros(self);
 
   // Move it forward in the current direction
-  switch (self->direction) {
-  case NORTH:
-    --self->head->pos.y;
-    break;
-  case EAST:
-    ++self->head->pos.x;
-    break;
-  case SOUTH:
-    ++self->head->pos.y;
-    break;
-  case WEST:
-    --self->head->pos.x;
-    break;
-  }
+  self->cell[self->head] = movedPoint(self->cell[self->head],
+                                      self->direction, 1);
 }
 
 void changeDirection(Snake *self, Direction newDirection) {
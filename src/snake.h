@@ -24,27 +24,48 @@ typedef struct point {
   int x, y;
 } Point;
 
-// The atomic piece that constitutes a Snake
-typedef struct node {
-  struct node *prev, *next;
-  Point pos;
-} Node;
-
-Node *newNode(const Point spawnPosition, Node *prev);
-void destroyNode(Node *self);
-
-// The Snake is modelled by a linked list
+// The Snake is modelled by a circular buffer: one contiguous allocation
+// holding every segment, stored in ring order from tail to head, so walking
+// the body is sequential memory instead of a pointer chase
 typedef struct snake {
-  unsigned length; // Also the score
-  Node *head, *tail;
-  Point oldTail; // Previous position of the tail
+  unsigned length;   // Also the score
+  unsigned capacity; // Size of the cell buffer, always a power of two
+  unsigned head;     // Index of the head segment in cell
+  Point *cell;       // The segments, a circular buffer
+  Point oldTail;     // Previous position of the tail
   bool growing;
   Direction direction;
 } Snake;
 
+// How one step moves a Point, indexed by Direction. A table lookup in
+// place of a 4-way switch keeps per-tick movement free of branches.
+extern const Point directionDelta[WEST + 1];
+
+// pos moved cells steps toward direction in one jump
+Point movedPoint(const Point pos, const Direction direction, const int cells);
+
 Snake *newSnake(const Point headPosition);
 void destroySnake(Snake *self);
 
+// Rewind to length 1 at headPosition in place, freeing nothing, so a new
+// game costs no allocation however long the previous one ran
+void resetSnake(Snake *self, const Point headPosition);
+
+// The segment at the head of the Snake
+Point *snakeHead(Snake *self);
+
+// The segment right behind the head, NULL when only the head is stored.
+// Safe in the window where a caller has bumped length for a pending
+// growth but advance() has not materialized the new segment yet.
+Point *snakeNeck(Snake *self);
+
+// The segment at the tip of the tail; like snakeNeck() it accounts for a
+// pending growth
+Point *snakeTail(Snake *self);
+
+// The segment at distance fromHead behind the head, fromHead < length
+Point *snakeSegment(Snake *self, const unsigned fromHead);
+
 // Pop the tail and push it as the new head
 void ouroboros(Snake *self);
 
@@ -57,4 +78,17 @@ void changeDirection(Snake *self, Direction newDirection);
 // If a self collision happens sets the parameter collision
 bool selfCollision(const Snake *self, Point *collision);
 
+// Copy the body into the SoA coordinate arrays x and y, tail first and
+// head last. Each must hold length entries. The two layouts exist for
+// pointMatches(): packed same-axis coordinates are what lets the compiler
+// compare a whole register of segments per instruction.
+void snakeCoordinates(const Snake *self, int *x, int *y);
+
+// How many of the count SoA points equal pos. The counting sweep is
+// branch-free so it vectorizes; when first is not NULL it receives the
+// index of the earliest match, or -1. Whole-body overlap scans go through
+// here instead of walking segments one at a time.
+unsigned pointMatches(const int *x, const int *y, const unsigned count,
+                      const Point pos, int *first);
+
 #endif // !SNAKE_H
@@ -0,0 +1,148 @@
+/* snapshot.c -- Save and restore the game state
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snapshot.h"
+
+#define SNAPSHOT_MAGIC "SNKS"
+#define SNAPSHOT_VERSION 2u
+
+typedef struct snapshotHeader {
+  char magic[4];
+  unsigned version;
+  int mapWidth, mapHeight; // Geometry the game was played on
+  unsigned length;
+  int direction;
+  unsigned char growing;
+  Point oldTail;
+  int orbCount; // That many orbs follow the body segments
+  int difficulty;
+  unsigned rngState;
+} SnapshotHeader;
+
+bool saveSnapshot(const char *path, const Snake *snake, const Orbs *orbs,
+                  const Difficulty difficulty, const Rng *rng,
+                  const int mapWidth, const int mapHeight) {
+  char tmpPath[512];
+  snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+  FILE *file = fopen(tmpPath, "wb");
+  if (file == NULL)
+    return false;
+
+  SnapshotHeader header = {.version = SNAPSHOT_VERSION,
+                           .mapWidth = mapWidth,
+                           .mapHeight = mapHeight,
+                           .length = snake->length,
+                           .direction = snake->direction,
+                           .growing = snake->growing,
+                           .oldTail = snake->oldTail,
+                           .orbCount = orbs->count,
+                           .difficulty = difficulty,
+                           .rngState = rng->state};
+  memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+  // The segments, tail to head: at most two bulk writes since the ring
+  // wraps around the buffer at most once. Saves run from the eat path,
+  // where length was already bumped for a pending growth the ring has
+  // not materialized: only the stored segments exist to be written, and
+  // loadSnapshot() rebuilds length from the growing flag.
+  const unsigned stored = snake->length - snake->growing;
+  const unsigned mask = snake->capacity - 1;
+  const unsigned tail = (snake->head + snake->capacity - (stored - 1)) & mask;
+  if (tail <= snake->head)
+    ok = ok &&
+         fwrite(snake->cell + tail, sizeof(Point), stored, file) == stored;
+  else {
+    const unsigned firstRun = snake->capacity - tail;
+    ok = ok &&
+         fwrite(snake->cell + tail, sizeof(Point), firstRun, file) ==
+             firstRun &&
+         fwrite(snake->cell, sizeof(Point), snake->head + 1, file) ==
+             snake->head + 1u;
+  }
+
+  ok = ok && fwrite(orbs->orb, sizeof(Point), orbs->count, file) ==
+                 (size_t)orbs->count;
+
+  ok = fclose(file) == 0 && ok;
+  return ok && rename(tmpPath, path) == 0;
+}
+
+Snake *loadSnapshot(const char *path, Orbs *orbs, Difficulty *difficulty,
+                    Rng *rng, const int mapWidth, const int mapHeight) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL)
+    return NULL;
+
+  SnapshotHeader header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != SNAPSHOT_VERSION || header.mapWidth != mapWidth ||
+      header.mapHeight != mapHeight || header.length == 0 ||
+      header.length <= header.growing ||
+      // A body longer than the map is corrupt, and an insane length would
+      // drive the capacity doubling below into a multi-gigabyte allocation
+      header.length > (unsigned)((mapWidth + 1) * (mapHeight + 1)) ||
+      header.direction < NORTH || header.direction > WEST ||
+      header.orbCount < 0) {
+    fclose(file);
+    return NULL;
+  }
+
+  // The file holds only the segments the ring stored; a growth pending
+  // at save time is re-created by the first advance() after resume
+  const unsigned stored = header.length - header.growing;
+
+  Snake *snake = newSnake((Point){0, 0});
+  unsigned capacity = snake->capacity;
+  while (capacity < header.length)
+    capacity *= 2;
+  if (capacity > snake->capacity) { // One allocation for the whole body
+    free(snake->cell);
+    snake->cell = malloc(sizeof(Point[capacity]));
+    snake->capacity = capacity;
+  }
+
+  // The file holds the segments tail to head; read them into one linear run
+  if (fread(snake->cell, sizeof(Point), stored, file) != stored) {
+    fclose(file);
+    destroySnake(snake);
+    return NULL;
+  }
+
+  orbsReset(orbs);
+  for (int i = 0; i < header.orbCount; ++i) {
+    Point orb;
+    if (fread(&orb, sizeof(Point), 1, file) != 1) {
+      fclose(file);
+      destroySnake(snake);
+      return NULL;
+    }
+    orbAdd(orbs, orb);
+  }
+  fclose(file);
+
+  snake->length = header.length;
+  snake->head = stored - 1;
+  snake->direction = header.direction;
+  snake->growing = header.growing;
+  snake->oldTail = header.oldTail;
+  *difficulty = header.difficulty;
+  rngSeed(rng, header.rngState);
+  return snake;
+}
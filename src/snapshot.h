@@ -0,0 +1,42 @@
+/* snapshot.h -- Save and restore the game state
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+
+#include "rng.h"
+#include "screen.h" // For Difficulty
+#include "snake.h"
+
+/* A snapshot is a compact versioned binary file: one header followed by the
+ * body segments in tail-to-head order and the live orbs, written with a
+ * handful of bulk writes no matter how long the Snake is. The occupancy
+ * Grid is not stored; it is rebuilt from the segments and orbs on load in
+ * one pass. The file is written to a temporary name and renamed, so a
+ * power cut never leaves a torn snapshot behind. */
+
+// Returns false when the file cannot be written
+bool saveSnapshot(const char *path, const Snake *snake, const Orbs *orbs,
+                  const Difficulty difficulty, const Rng *rng,
+                  const int mapWidth, const int mapHeight);
+
+// The restored Snake, or NULL when there is no usable snapshot or it was
+// taken on a map of different dimensions. Outputs the rest of the state;
+// orbs is reset and refilled with the saved set.
+Snake *loadSnapshot(const char *path, Orbs *orbs, Difficulty *difficulty,
+                    Rng *rng, const int mapWidth, const int mapHeight);
+
+#endif // !SNAPSHOT_H
@@ -0,0 +1,192 @@
+/* tournament.c -- Parallel tournament driver
+ *
+ * Copyright (C) 2024  Mario D'Andrea <https://ormai.dev>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details. */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "autopilot.h"
+#include "engine.h"
+#include "metrics.h"
+#include "replay.h"
+
+/* Runs batches of independent autopilot games in one process, spread
+ * across a pool of worker threads. Every worker owns one Engine and one
+ * Autopilot at a time and writes outcomes into slots of the result array
+ * no other worker touches, so there is no shared mutable game state; the
+ * only coordination is one atomic counter handing out game numbers. Game
+ * g plays on seed baseSeed + g, the same (width, height, seed) triple the
+ * replay subsystem keys a trace by, so any single game can be re-executed
+ * and inspected offline.
+ *
+ * Usage: snake-tournament [width height] [--games N] [--workers N]
+ *                         [--seed N] [--record FILE]
+ * --record saves the trace of the best-scoring game of the tournament. */
+
+// Per-game outcome, written only by the worker that played the game
+typedef struct result {
+  unsigned score, ticks;
+  bool won;
+} Result;
+
+// Everything a worker needs: the shared read-only configuration, the one
+// scheduling counter and its private best-trace slot
+typedef struct worker {
+  pthread_t thread;
+  int width, height;
+  unsigned games, baseSeed;
+  bool record;
+  _Atomic unsigned *nextGame; // Shared; fetch-add schedules the games
+  Result *result;             // Shared array, one exclusive slot per game
+  Replay *bestTrace; // This worker's best game, merged at the end
+  unsigned bestScore;
+} Worker;
+
+// Play games handed out by the counter until none are left
+static void *runGames(void *arg) {
+  Worker *self = arg;
+  Autopilot *pilot = newAutopilot(self->width, self->height);
+
+  for (;;) {
+    const unsigned game = atomic_fetch_add(self->nextGame, 1);
+    if (game >= self->games)
+      break;
+    const unsigned seed = self->baseSeed + game;
+    Engine *engine = newEngine(self->width, self->height, seed);
+    Replay *trace = self->record
+                        ? newReplay(self->width, self->height, seed)
+                        : NULL;
+
+    while (!engine->over) {
+      Snake *snake = engine->snake[0];
+      const Direction steer =
+          autopilotSteer(pilot, engine->grid, snake, engine->orb);
+      if (trace != NULL && steer != snake->direction)
+        replayRecord(trace, engine->tick, steer);
+      changeDirection(snake, steer);
+      engineTick(engine);
+    }
+
+    const unsigned score = engine->snake[0]->length;
+    self->result[game] = (Result){
+        .score = score, .ticks = engine->tick, .won = engine->won};
+    if (trace != NULL) { // Keep only this worker's best game
+      if (score > self->bestScore) {
+        destroyReplay(self->bestTrace);
+        self->bestTrace = trace;
+        self->bestScore = score;
+      } else
+        destroyReplay(trace);
+    }
+    destroyEngine(engine);
+  }
+
+  destroyAutopilot(pilot);
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  int width = 80, height = 24, positionals = 0;
+  unsigned games = 256, workers = 0, seed = 1;
+  const char *recordPath = NULL;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--games") == 0 && i + 1 < argc)
+      games = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+      workers = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+      seed = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+      recordPath = argv[++i];
+    else if (positionals == 0)
+      width = atoi(argv[i]), ++positionals;
+    else if (positionals == 1)
+      height = atoi(argv[i]), ++positionals;
+    else {
+      fprintf(stderr,
+              "usage: %s [width height] [--games N] [--workers N] "
+              "[--seed N] [--record FILE]\n",
+              argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (width < 2 || height < 2 || games == 0) {
+    fprintf(stderr, "%s: the map must be at least 2x2\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (workers == 0) { // One worker per core unless told otherwise
+    const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    workers = cores > 0 ? (unsigned)cores : 1;
+  }
+  if (workers > games)
+    workers = games;
+
+  Result *result = malloc(sizeof(Result[games]));
+  Worker *worker = malloc(sizeof(Worker[workers]));
+  _Atomic unsigned nextGame = 0;
+
+  const long long started = metricsNow();
+  for (unsigned w = 0; w < workers; ++w) {
+    worker[w] = (Worker){.width = width,
+                         .height = height,
+                         .games = games,
+                         .baseSeed = seed,
+                         .record = recordPath != NULL,
+                         .nextGame = &nextGame,
+                         .result = result,
+                         .bestTrace = NULL,
+                         .bestScore = 0};
+    pthread_create(&worker[w].thread, NULL, runGames, &worker[w]);
+  }
+  for (unsigned w = 0; w < workers; ++w)
+    pthread_join(worker[w].thread, NULL);
+  const long long elapsed = metricsNow() - started;
+
+  // Merge the per-worker buffers now that everyone is done
+  unsigned wins = 0, best = 0, bestGame = 0;
+  unsigned long long ticks = 0, scores = 0;
+  for (unsigned g = 0; g < games; ++g) {
+    wins += result[g].won;
+    ticks += result[g].ticks;
+    scores += result[g].score;
+    if (result[g].score > best) {
+      best = result[g].score;
+      bestGame = g;
+    }
+  }
+  Replay *bestTrace = NULL;
+  for (unsigned w = 0; w < workers; ++w)
+    if (worker[w].bestTrace != NULL && worker[w].bestScore >= best &&
+        bestTrace == NULL)
+      bestTrace = worker[w].bestTrace;
+  if (recordPath != NULL && bestTrace != NULL &&
+      !replaySave(bestTrace, recordPath))
+    fprintf(stderr, "%s: cannot write trace %s\n", argv[0], recordPath);
+
+  printf("games %u won %u mean score %.1f best %u (game %u, seed %u) "
+         "ticks %llu in %.2fs (%.0f games/s)\n",
+         games, wins, (double)scores / games, best, bestGame,
+         seed + bestGame, ticks, elapsed / 1e9, games / (elapsed / 1e9));
+
+  for (unsigned w = 0; w < workers; ++w)
+    destroyReplay(worker[w].bestTrace);
+  free(worker);
+  free(result);
+  return EXIT_SUCCESS;
+}